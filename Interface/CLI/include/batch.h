@@ -0,0 +1,16 @@
+#ifndef CLI_BATCH_H
+#define CLI_BATCH_H
+
+#include <string>
+#include <evalLimits.h>
+#include <renderer.h>
+
+// `--batch`: render each script listed in manifest file, one `script [output]` per line; blank lines
+// and lines starting with `#` are skipped. Output defaults to script with `.bmp` extension.
+// Scripts are spread over workers threads, each reusing one Image; limits apply to each script,
+// and heap is counted per thread, so max-heap bounds the memory of a worker.
+// Failures are reported to stderr; returns the number of them.
+unsigned renderBatch(const std::string &manifest, const Renderer &renderer,
+                     const context::Limits &limits, unsigned workers);
+
+#endif //CLI_BATCH_H
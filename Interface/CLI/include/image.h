@@ -12,8 +12,14 @@ public:
 
     void save(const char *const filename);
 
+    // BMP file content, as save() writes it
+    std::string encode() const;
+
     void set(int x, int y, float value);
 
+    // Back to blank white
+    void clear();
+
 private:
     std::shared_ptr<ImageImpl> impl;
 };
@@ -0,0 +1,26 @@
+#ifndef CLI_RENDERER_H
+#define CLI_RENDERER_H
+
+#include <string>
+#include <context.h>
+#include <evalLimits.h>
+#include <image.h>
+
+// Renders scripts in child scopes of a base scope that has stdlib loaded, so stdlib is only loaded once.
+// The base scope must not have #painter: each render adds its own to the child scope, and stdlib
+// functions find it through dynamic scope. Rendering only reads the base scope, so one Renderer
+// serves several threads at once, each with its own Image.
+class Renderer {
+public:
+    explicit Renderer(context::pScope base);
+
+    // Clear image, evaluate source in a fresh child scope and draw into image.
+    // name shows up in locations of anonymous functions. Errors of evaluation are thrown.
+    void render(const std::string &source, const std::string &name,
+                Image &image, const context::Limits &limits) const;
+
+private:
+    context::pScope base;
+};
+
+#endif //CLI_RENDERER_H
@@ -0,0 +1,17 @@
+#ifndef CLI_SERVER_H
+#define CLI_SERVER_H
+
+#include <string>
+#include <evalLimits.h>
+#include <renderer.h>
+
+// `--serve`: render requests sent to a Unix socket until the process is killed.
+// A request is option lines (`max-steps N`, `max-depth N`, `max-heap MB`, `timeout MS`), an empty line
+// and the script; the client then shuts down writing. The reply is `OK <size>\n` followed by the BMP,
+// or `ERROR <message>\n`. Each of `workers` threads accepts and renders one request at a time.
+// Options of a request can only tighten the defaults, since scripts are untrusted. A request must
+// be sent within a receive timeout and a size limit.
+void serve(const std::string &socketPath, const Renderer &renderer,
+           const context::Limits &defaults, unsigned workers);
+
+#endif //CLI_SERVER_H
@@ -1,12 +1,13 @@
 #include <CLIbuiltinDrawAST.h>
 #include <context.h>
+#include <tracer.h>
 
 using namespace std;
 
 std::pair<float, float> ast::CLIBuiltinDrawAST::toPair(const std::shared_ptr<ExprAST> &ptr) const {
-    if (auto pairPtr = dynamic_pointer_cast<PairAST>(ptr)) {
-        float first = (float) dynamic_pointer_cast<NumberAST>(pairPtr->data.first)->getValue();
-        float second = (float) dynamic_pointer_cast<NumberAST>(pairPtr->data.second)->getValue();
+    if (auto pairPtr = nodeAs<PairAST>(ptr)) {
+        float first = (float) nodeAs<NumberAST>(pairPtr->data.first)->getValue();
+        float second = (float) nodeAs<NumberAST>(pairPtr->data.second)->getValue();
 
         return make_pair(first, 1000 - second);
     } else {
@@ -16,13 +17,17 @@ std::pair<float, float> ast::CLIBuiltinDrawAST::toPair(const std::shared_ptr<Exp
 
 std::shared_ptr<ast::ExprAST>
 ast::CLIBuiltinDrawAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    profiler::TraceScope trace{"draw", "#painter"};
     auto exprPtr = actualArgs.front()->eval(s);
-    while (!dynamic_pointer_cast<NilAST>(exprPtr)) {
-        auto pairPtr = dynamic_pointer_cast<PairAST>(exprPtr);
+    size_t points = 0;
+    while (!nodeAs<NilAST>(exprPtr)) {
+        auto pairPtr = nodeAs<PairAST>(exprPtr);
         auto pair = toPair(pairPtr->data.first);
         image.set(static_cast<int>(pair.first), static_cast<int>(pair.second), 0);
         exprPtr = pairPtr->data.second;
+        points++;
     }
+    if (trace.sampled()) trace.setDetail(to_string(points) + " points");
     s->stepOutFunc();
     return std::make_shared<CLIBuiltinDrawAST>(image);
 }
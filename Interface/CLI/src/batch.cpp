@@ -0,0 +1,74 @@
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <batch.h>
+
+using namespace std;
+using namespace context;
+
+namespace {
+    struct Task {
+        string script, output;
+    };
+
+    // script with the extension of its file name, if any, replaced by .bmp. Dots in directory
+    // names, or the one starting a hidden file name, aren't an extension.
+    string defaultOutput(const string &script) {
+        auto slash = script.find_last_of('/');
+        auto name = slash == string::npos ? 0 : slash + 1;
+        auto dot = script.find_last_of('.');
+        if (dot == string::npos || dot <= name) return script + ".bmp";
+        return script.substr(0, dot) + ".bmp";
+    }
+
+    vector<Task> readManifest(const string &manifest) {
+        ifstream fin{manifest};
+        if (!fin) throw runtime_error("Cannot open manifest " + manifest);
+        vector<Task> tasks;
+        string line;
+        while (getline(fin, line)) {
+            stringstream ss{line};
+            Task task;
+            if (!(ss >> task.script) || task.script[0] == '#') continue;
+            if (!(ss >> task.output)) task.output = defaultOutput(task.script);
+            tasks.push_back(task);
+        }
+        return tasks;
+    }
+}
+
+unsigned renderBatch(const std::string &manifest, const Renderer &renderer,
+                     const context::Limits &limits, unsigned workers) {
+    auto tasks = readManifest(manifest);
+    atomic<size_t> next{0};
+    atomic<unsigned> failures{0};
+    mutex errMutex;
+
+    auto work = [&]() {
+        // Same size as image of a single render in main
+        Image image(1001, 1001);
+        for (size_t i; (i = next++) < tasks.size();) {
+            try {
+                ifstream fin{tasks[i].script};
+                if (!fin) throw runtime_error("Cannot open script");
+                string source{istreambuf_iterator<char>(fin), istreambuf_iterator<char>()};
+                renderer.render(source, tasks[i].script, image, limits);
+                image.save(tasks[i].output.c_str());
+            } catch (std::exception &e) {
+                failures++;
+                lock_guard<mutex> lock{errMutex};
+                cerr << tasks[i].script << ": " << e.what() << endl;
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 1; i < workers && i < tasks.size(); i++) pool.emplace_back(work);
+    work();
+    for (auto &t : pool) t.join();
+    return failures;
+}
@@ -2,8 +2,11 @@
 
 // Attention: "3" means high debug messages
 #define cimg_verbosity 3
+#include <cstdio>
+#include <stdexcept>
 #include <CImg.h>
 #include <image.h>
+#include <tracer.h>
 
 using namespace std;
 
@@ -16,10 +19,18 @@ public:
         image.save(filename);
     }
 
+    void saveBMP(std::FILE *file) const {
+        image.save_bmp(file);
+    }
+
     void set(int x, int y, float value) {
         image(x, y, 0) = image(x, y, 1) = image(x, y, 2) = value;
     }
 
+    void clear() {
+        image.fill(255);
+    }
+
 private:
     cimg_library::CImg<float> image;
 
@@ -30,9 +41,29 @@ Image::Image(int length, int width) : impl(make_shared<ImageImpl>(length, width)
 }
 
 void Image::save(const char *const filename) {
+    profiler::TraceScope trace{"image", "save"};
     impl->save(filename);
+    if (trace.sampled()) trace.setDetail(filename);
+}
+
+std::string Image::encode() const {
+    profiler::TraceScope trace{"image", "encode"};
+    // CImg writes BMP to a FILE only
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{std::tmpfile(), std::fclose};
+    if (!file) throw std::runtime_error("Cannot create temporary file to encode image");
+    impl->saveBMP(file.get());
+    std::string bytes;
+    if (std::fseek(file.get(), 0, SEEK_END) == 0) bytes.resize(std::ftell(file.get()));
+    std::rewind(file.get());
+    if (std::fread(&bytes[0], 1, bytes.size(), file.get()) != bytes.size())
+        throw std::runtime_error("Cannot read encoded image");
+    return bytes;
 }
 
 void Image::set(int x, int y, float value) {
     impl->set(x, y, value);
 }
+
+void Image::clear() {
+    impl->clear();
+}
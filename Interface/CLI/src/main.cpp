@@ -1,5 +1,8 @@
 #include <exception>
 #include <iostream>
+#include <fstream>
+#include <future>
+#include <thread>
 #include <vector>
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -9,7 +12,17 @@
 #include <exception.h>
 #include <cxxopts.hpp>
 #include <visitor.h>
+#include <optimizer.h>
+#include <profiler.h>
+#include <tracer.h>
+#include <memstats.h>
+#include <internTable.h>
+#include <evalLimits.h>
+#include <embeddedLib.h>
 #include <CLIbuiltinDrawAST.h>
+#include <renderer.h>
+#include <server.h>
+#include <batch.h>
 
 using namespace std;
 using namespace ast;
@@ -39,38 +52,102 @@ int main(int argc, char *argv[]) {
         Options options(argv[0], " - Scheme Interpreter/painter command line options");
         options.add_options()("o,output", "output image", value<std::string>())
             ("src", "src filename", cxxopts::value<std::vector<std::string>>())
-            ("p,path", "stdlib path", cxxopts::value<std::string>())
+            ("p,path", "stdlib path, override the stdlib embedded in binary", cxxopts::value<std::string>())
             ("nostdlib", "Do not use stdlib")
             ("nopainter", "Do not use painter-related lib")
+            ("j,jobs", "Parse src files with N threads, or serve/batch with N workers", cxxopts::value<unsigned>())
+            ("no-opt", "Do not optimize AST before evaluation")
+            ("profile", "Profile functions, write collapsed stacks to file and report to stderr",
+             cxxopts::value<std::string>())
+            ("trace", "Write Chrome trace events of parsing, loading and drawing to file",
+             cxxopts::value<std::string>())
+            ("trace-threshold", "Drop trace events shorter than N microseconds (default 100)",
+             cxxopts::value<unsigned>())
+            ("mem-stats", "Count objects per AST node type, print report to stderr at exit")
+            ("hash-cons", "Share structurally equal numbers and pairs made by evaluation")
+            ("max-steps", "Abort src evaluation after N function calls", cxxopts::value<unsigned long>())
+            ("max-depth", "Abort src evaluation beyond N nested calls", cxxopts::value<size_t>())
+            ("max-heap", "Abort src evaluation once it holds more than N MB", cxxopts::value<size_t>())
+            ("timeout", "Abort src evaluation after N milliseconds", cxxopts::value<unsigned>())
+            ("serve", "Render scripts sent to Unix socket, limits above are defaults of requests",
+             cxxopts::value<std::string>())
+            ("batch", "Render scripts listed in manifest file, limits above apply to each",
+             cxxopts::value<std::string>())
             ("h,help", "Print help");
         options.parse_positional("src");
         options.parse(argc, argv);
+        // The profiler expects evaluation in a single thread
+        if (options.count("profile") && (options.count("batch") || options.count("serve")))
+            throw OptionException("--profile can't be used with --batch or --serve");
 
         if (options.count("h")) {
             cout << options.help({""}) << endl;
             return 0;
         }
-        if (!options.count("nostdlib") && !options.count("path")) {
-            cout << "You must specify -nostdlib or -path" << endl;
-            return 0;
-        }
+        OptimizeVisitor::enabled = !options.count("no-opt");
+        profiler::Profiler::enabled = options.count("profile") > 0;
+        profiler::AllocationCounting counting{profiler::Profiler::enabled};
+        profiler::Tracer::enabled = options.count("trace") > 0;
+        profiler::MemoryStats::enabled = options.count("mem-stats") > 0;
+        InternTable::enabled = options.count("hash-cons") > 0;
+        if (options.count("trace-threshold"))
+            profiler::Tracer::threshold = std::chrono::microseconds{options["trace-threshold"].as<unsigned>()};
         Lexer lex;
         auto scope = std::make_shared<Scope>();
-        auto path = options["path"].as<std::string>();
+        auto loadLib = [&](const std::string &name) {
+            if (options.count("path"))
+                lex.appendExp("(load \"" + options["path"].as<std::string>() + "/" + name + "\")");
+            else
+                lex.appendExp(embedded::source(name));
+        };
         if (!options.count("nostdlib")) {
-            lex.appendExp("(load \"" + path + "/Base.scm\")");
+            loadLib("Base.scm");
         }
+        auto sharedBase = options.count("serve") || options.count("batch");
         if (!options.count("nopainter") && !options.count("nostdlib")) {
-            scope->addBuiltinFunc("#painter", std::make_shared<ast::CLIBuiltinDrawAST>(image));
-            lex.appendExp("(load \"" + path + "/Shape.scm\")");
-            lex.appendExp("(load \"" + path + "/Frame.scm\")");
+            // Each render of --serve/--batch has its own image and #painter, see Renderer
+            if (!sharedBase) scope->addBuiltinFunc("#painter", std::make_shared<ast::CLIBuiltinDrawAST>(image));
+            loadLib("Shape.scm");
+            loadLib("Frame.scm");
         }
-        auto ast = parseAllExpr(lex);
+        auto ast = optimize(parseAllExpr(lex));
         ast->eval(scope);
+        // Limits apply to src files only, stdlib is trusted
+        Limits limits;
+        if (options.count("max-steps")) limits.steps = options["max-steps"].as<unsigned long>();
+        if (options.count("max-depth")) limits.depth = options["max-depth"].as<size_t>();
+        if (options.count("max-heap")) limits.heap = options["max-heap"].as<size_t>() * 1024 * 1024;
+        if (options.count("timeout")) limits.time = std::chrono::milliseconds{options["timeout"].as<unsigned>()};
+        if (sharedBase) {
+            auto workers = options.count("jobs") ? options["jobs"].as<unsigned>()
+                                                 : std::max(1u, std::thread::hardware_concurrency());
+            if (options.count("batch"))
+                return renderBatch(options["batch"].as<std::string>(), Renderer{scope}, limits, workers) ? 1 : 0;
+            serve(options["serve"].as<std::string>(), Renderer{scope}, limits, workers);
+            return 0;
+        }
         auto &v = options["src"].as<std::vector<std::string>>();
-        for (const auto &s : v) {
-            lex.appendExp(string("(load \"") + s + "\")");
-            auto ast = std::dynamic_pointer_cast<AllExprAST>(parseAllExpr(lex));
+        auto jobs = options.count("jobs") ? options["jobs"].as<unsigned>() : 1;
+        LimitGuard guard{limits};
+        // Parsing doesn't depend on evaluation, so all src files are parsed ahead in parallel mode
+        std::vector<std::future<pExpr>> parsed;
+        if (jobs > 1) {
+            for (const auto &s : v)
+                parsed.push_back(std::async(std::launch::async, [s, jobs]() {
+                    std::ifstream fin{s};
+                    if (!fin) throw std::runtime_error("Cannot open " + s);
+                    std::string str{std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
+                    return optimize(parseAllExpr(str, jobs, s));
+                }));
+        }
+        for (size_t i = 0; i < v.size(); i++) {
+            std::shared_ptr<AllExprAST> ast;
+            if (jobs > 1) {
+                ast = nodeCast<AllExprAST>(parsed[i].get());
+            } else {
+                lex.appendExp(string("(load \"") + v[i] + "\")");
+                ast = nodeCast<AllExprAST>(parseAllExpr(lex));
+            }
             auto ret = ast->evalAll(scope);
             for (auto ptr: ret) {
                 if (ptr) {
@@ -86,6 +163,16 @@ int main(int argc, char *argv[]) {
             auto basename = v.back().substr(0, p) + ".bmp";
             image.save(basename.c_str());
         }
+        if (options.count("profile")) {
+            std::ofstream fout{options["profile"].as<std::string>()};
+            profiler::Profiler::collapsedStacks(fout);
+            profiler::Profiler::report(cerr);
+        }
+        if (options.count("mem-stats")) profiler::MemoryStats::report(cerr);
+        if (options.count("trace")) {
+            std::ofstream fout{options["trace"].as<std::string>()};
+            profiler::Tracer::write(fout);
+        }
         //} catch (RuntimeError &e) {
         //cout << e.what() << endl;
         //throw;
@@ -0,0 +1,24 @@
+#include <lexers.h>
+#include <parser.h>
+#include <optimizer.h>
+#include <renderer.h>
+#include <CLIbuiltinDrawAST.h>
+
+using namespace context;
+
+Renderer::Renderer(pScope base) : base{std::move(base)} {
+}
+
+void Renderer::render(const std::string &source, const std::string &name,
+                      Image &image, const Limits &limits) const {
+    image.clear();
+    auto scope = std::make_shared<Scope>();
+    scope->setLexicalScope(base);
+    scope->addBuiltinFunc("#painter", std::make_shared<ast::CLIBuiltinDrawAST>(image));
+
+    lexers::Lexer lex;
+    lex.setName(name);
+    lex.appendExp(source);
+    LimitGuard guard{limits};
+    visitor::optimize(parser::parseAllExpr(lex))->eval(scope);
+}
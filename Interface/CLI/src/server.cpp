@@ -0,0 +1,136 @@
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <server.h>
+
+using namespace std;
+using namespace context;
+
+namespace {
+    // A client that sends more, or stalls longer, would keep a worker from others
+    const size_t MAX_REQUEST_SIZE = 16 * 1024 * 1024;
+    const time_t RECEIVE_TIMEOUT_S = 10;
+
+    string readAll(int fd) {
+        timeval timeout{RECEIVE_TIMEOUT_S, 0};
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout) < 0)
+            throw runtime_error(string("Cannot set receive timeout: ") + strerror(errno));
+        string data;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof buf)) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) throw runtime_error("Timed out reading request");
+                throw runtime_error(string("Cannot read request: ") + strerror(errno));
+            }
+            data.append(buf, static_cast<size_t>(n));
+            if (data.size() > MAX_REQUEST_SIZE)
+                throw runtime_error("Request is larger than " + to_string(MAX_REQUEST_SIZE) + " bytes");
+        }
+        return data;
+    }
+
+    void writeAll(int fd, const string &data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            auto n = write(fd, data.data() + done, data.size() - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                // Client is gone, nothing to tell it
+                return;
+            }
+            done += static_cast<size_t>(n);
+        }
+    }
+
+    // A request may only tighten a limit; 0 leaves it as it is
+    template<class T>
+    void tighten(T &limit, T requested) {
+        if (requested != T{} && (limit == T{} || requested < limit)) limit = requested;
+    }
+
+    // Split request into limits and script
+    string parseRequest(const string &request, Limits &limits) {
+        // No options at all if request starts with the empty line
+        auto end = request.compare(0, 1, "\n") == 0 ? 0 : request.find("\n\n");
+        if (end == string::npos) throw runtime_error("Request has no empty line before script");
+        auto script = end == 0 ? 1 : end + 2;
+        stringstream header{request.substr(0, end)};
+        string line;
+        while (getline(header, line)) {
+            stringstream ss{line};
+            string key;
+            unsigned long value;
+            if (!(ss >> key >> value)) throw runtime_error("Malformed option: " + line);
+            if (key == "max-steps") tighten(limits.steps, value);
+            else if (key == "max-depth") tighten<size_t>(limits.depth, value);
+            else if (key == "max-heap") tighten<size_t>(limits.heap, value * 1024 * 1024);
+            else if (key == "timeout") tighten(limits.time, chrono::milliseconds{value});
+            else throw runtime_error("Unknown option: " + key);
+        }
+        return request.substr(script);
+    }
+
+    void work(int listenFd, const Renderer &renderer, const Limits &defaults, unsigned id) {
+        // Same size as image of a single render in main
+        Image image(1001, 1001);
+        unsigned long served = 0;
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                cerr << "serve: accept failed: " << strerror(errno) << endl;
+                return;
+            }
+            string reply;
+            try {
+                auto limits = defaults;
+                auto script = parseRequest(readAll(fd), limits);
+                renderer.render(script, "<request " + to_string(id) + "." + to_string(served++) + ">",
+                                image, limits);
+                auto bmp = image.encode();
+                reply = "OK " + to_string(bmp.size()) + "\n" + bmp;
+            } catch (std::exception &e) {
+                reply = string("ERROR ") + e.what() + "\n";
+            }
+            writeAll(fd, reply);
+            close(fd);
+        }
+    }
+}
+
+void serve(const std::string &socketPath, const Renderer &renderer,
+           const context::Limits &defaults, unsigned workers) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof addr.sun_path) throw runtime_error("Socket path too long: " + socketPath);
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof addr.sun_path - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw runtime_error(string("Cannot create socket: ") + strerror(errno));
+    // Left over by a previous run
+    unlink(socketPath.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof addr) < 0 || listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        throw runtime_error("Cannot listen on " + socketPath + ": " + strerror(errno));
+    }
+    // A client closing early must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    vector<thread> pool;
+    for (unsigned i = 0; i < workers; i++)
+        pool.emplace_back(work, fd, std::cref(renderer), std::cref(defaults), i);
+    for (auto &t : pool) t.join();
+    close(fd);
+    unlink(socketPath.c_str());
+}
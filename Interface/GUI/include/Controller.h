@@ -5,10 +5,14 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <future>
 #include <SFML/Graphics.hpp>
 #include <formatString.h>
+#include <spscQueue.h>
 #include <context.h>
+#include <evalLimits.h>
 #include <parser.h>
+#include <reader.h>
 
 namespace ast {
     class BuiltinDrawAST;
@@ -95,18 +99,31 @@ namespace con {
     public:
         Controller(Window &text, Window &board);
 
+        ~Controller();
+
+        // Take shapes and result of the background evaluation, call it once per frame
+        void update();
+
         void drawToWindows();
 
         void appendChar(char);
 
+        // Called by #painter in the evaluation thread
         void appendShape(const VertexArray &);
 
         void moveScreen(float);
 
         void clearScreen();
 
+        // Start evaluating current input in background; ignored while an evaluation is running
         void execute();
 
+        // Stop the running evaluation at its next check point
+        void cancel();
+
+        // Block until the running evaluation finishes, then update()
+        void wait();
+
         enum charType {
             BackSpace,
             LineFeed,
@@ -126,16 +143,24 @@ namespace con {
 
         void normalCharProcess(char c);
 
-        Text evaluation();
+        void finishExecution(const Text &result);
 
         Window &textWindow;
         mutable Text currentText;
         std::vector<Text> history;
         context::pScope scope;
+        // keep unfinished form across execute(), so that each form is parsed only once
+        parser::Reader reader;
 
         Window &drawingBoard;
         std::vector<con::VertexArray> shapes;
 
+        // Evaluation runs in its own thread so that windows keep redrawing; Scope and call trace are
+        // only touched by that thread until it finishes. Its shapes come through shapeQueue.
+        std::future<Text> running;
+        context::CancelToken cancelToken;
+        SpscQueue<VertexArray, 256> shapeQueue;
+
     };
 }
 
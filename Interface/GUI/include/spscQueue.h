@@ -0,0 +1,42 @@
+#ifndef GI_SPSCQUEUE_H
+#define GI_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace con {
+    // Bounded lock-free queue for exactly one producer thread and one consumer thread.
+    // One slot is kept empty to tell a full queue from an empty one, so it holds N - 1 items.
+    template<class T, std::size_t N>
+    class SpscQueue {
+    public:
+        // Producer only; false if the queue is full
+        bool push(T item) {
+            auto t = tail.load(std::memory_order_relaxed);
+            auto next = (t + 1) % N;
+            if (next == head.load(std::memory_order_acquire)) return false;
+            buffer[t] = std::move(item);
+            tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only; false if the queue is empty
+        bool pop(T &item) {
+            auto h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) return false;
+            item = std::move(buffer[h]);
+            head.store((h + 1) % N, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::array<T, N> buffer;
+        // On separate cache lines, so producer and consumer don't invalidate each other's
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+    };
+}
+
+#endif //GI_SPSCQUEUE_H
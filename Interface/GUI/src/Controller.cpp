@@ -1,5 +1,6 @@
 #include <stack>
 #include <string>
+#include <thread>
 #include <Controller.h>
 #include <GUIbuiltinDrawAST.h>
 #include <exception.h>
@@ -14,6 +15,8 @@ using namespace exception;
 using namespace visitor;
 
 void Controller::appendChar(char c) {
+    // Input typed while evaluating would be dropped by finishExecution()
+    if (running.valid()) return;
     if (!toType.count(c))
         return normalCharProcess(c);
     switch (toType[c]) {
@@ -45,46 +48,88 @@ void Controller::moveScreen(float delta) {
 }
 
 void Controller::clearScreen() {
+    cancel();
+    wait();
     history.clear();
     currentText.clearStr();
+    reader.clear();
     scope->clear();
 }
 
 void Controller::execute() {
+    if (running.valid()) return;
     history.push_back(currentText);
-    history.push_back(evaluation());
 
-    currentText.offsetY = history.back().offsetY + history.back().getHeight();
-    currentText.clearStr();
-    pushString(currentText.formatString, "]=> ");
-
-    adjustText();
-}
-
-con::Text Controller::evaluation() {
     Text resultText;
     resultText.color = sf::Color::Blue;
     resultText.offsetY = currentText.offsetY + currentText.getHeight();
     pushString(resultText.formatString, ";Value: ");
 
+    // Parsing is quick, so it stays in UI thread; only evaluation goes to background
+    std::shared_ptr<ast::ExprAST> ast;
     try {
-        lexers::Lexer lex(currentText.formatString.toString().substr(4));
-        DisplayVisitor disp;
-        auto ast = parseAllExpr(lex);
-
-        if (auto ptr = ast->eval(scope, ast)) {
-            ptr->accept(disp);
-            pushString(resultText.formatString, disp.to_string());
-        } else {
-            pushString(resultText.formatString, "\'()");
+        reader.appendExp(currentText.formatString.toString().substr(4));
+        if (!reader.ready()) {
+            pushString(resultText.formatString, "(" + to_string(reader.depth()) + " bracket(s) unclosed)");
+            return finishExecution(resultText);
         }
+        ast = reader.parseReady();
     } catch (std::logic_error &e) {
         pushString(resultText.formatString, e.what());
+        return finishExecution(resultText);
     } catch (RuntimeError &e) {
         pushString(resultText.formatString, e.what());
+        return finishExecution(resultText);
     }
 
-    return resultText;
+    cancelToken = CancelToken{};
+    running = std::async(std::launch::async, [this, ast, resultText]() mutable {
+        Limits limits;
+        limits.cancel = cancelToken;
+        LimitGuard guard{limits};
+        try {
+            DisplayVisitor disp;
+            if (auto ptr = ast->eval(scope)) {
+                ptr->accept(disp);
+                pushString(resultText.formatString, disp.to_string());
+            } else {
+                pushString(resultText.formatString, "\'()");
+            }
+        } catch (std::logic_error &e) {
+            pushString(resultText.formatString, e.what());
+        } catch (RuntimeError &e) {
+            pushString(resultText.formatString, e.what());
+        }
+        return resultText;
+    });
+}
+
+void Controller::finishExecution(const Text &result) {
+    history.push_back(result);
+
+    currentText.offsetY = history.back().offsetY + history.back().getHeight();
+    currentText.clearStr();
+    pushString(currentText.formatString, "]=> ");
+
+    adjustText();
+}
+
+void Controller::cancel() {
+    if (running.valid()) cancelToken.cancel();
+}
+
+void Controller::update() {
+    VertexArray va;
+    while (shapeQueue.pop(va)) shapes.push_back(va);
+    if (running.valid() && running.wait_for(std::chrono::seconds{0}) == std::future_status::ready)
+        finishExecution(running.get());
+}
+
+void Controller::wait() {
+    // Keep draining shapes, the evaluation thread waits for room in the queue
+    while (running.valid() && running.wait_for(std::chrono::milliseconds{10}) != std::future_status::ready)
+        update();
+    update();
 }
 
 void Controller::drawToWindows() {
@@ -97,7 +142,8 @@ void Controller::drawToWindows() {
 }
 
 void Controller::appendShape(const con::VertexArray &va) {
-    shapes.push_back(va);
+    // Queue is full only if UI thread is behind by a few frames, wait for it
+    while (!shapeQueue.push(va)) std::this_thread::yield();
 }
 
 void con::Text::draw(sf::RenderTarget &target, sf::RenderStates states) const {
@@ -125,6 +171,11 @@ con::Controller::Controller(Window &text, Window &board)
     pushString(currentText.formatString, "]=> ");
 }
 
+con::Controller::~Controller() {
+    cancel();
+    wait();
+}
+
 void Controller::adjustText() {
     if (history.empty()) return;
     auto newline = currentText.fontSize;
@@ -6,8 +6,8 @@ std::shared_ptr<ast::ExprAST>
 ast::GUIBuiltinDrawAST::apply(const std::vector<pExpr> actualArgs, pScope &s) {
     con::VertexArray vertex;
     auto exprPtr = actualArgs.front()->eval(s, actualArgs.front());
-    while (!dynamic_pointer_cast<NilAST>(exprPtr)) {
-        auto pairPtr = dynamic_pointer_cast<PairAST>(exprPtr);
+    while (!nodeAs<NilAST>(exprPtr)) {
+        auto pairPtr = nodeAs<PairAST>(exprPtr);
         vertex.append(sf::Vertex{toVec2f(pairPtr->data.first), sf::Color::Black});
         exprPtr = pairPtr->data.second;
     }
@@ -16,9 +16,9 @@ ast::GUIBuiltinDrawAST::apply(const std::vector<pExpr> actualArgs, pScope &s) {
 }
 
 sf::Vector2f ast::GUIBuiltinDrawAST::toVec2f(const shared_ptr<ast::ExprAST> &ptr) const {
-    if (auto pairPtr = dynamic_pointer_cast<PairAST>(ptr)) {
-        auto firstPtr = dynamic_pointer_cast<NumberAST>(pairPtr->data.first);
-        auto secondPtr = dynamic_pointer_cast<NumberAST>(pairPtr->data.second);
+    if (auto pairPtr = nodeAs<PairAST>(ptr)) {
+        auto firstPtr = nodeAs<NumberAST>(pairPtr->data.first);
+        auto secondPtr = nodeAs<NumberAST>(pairPtr->data.second);
 
         auto vec2f = sf::Vector2f(static_cast<float>(firstPtr->getValue()),
                                   static_cast<float>(secondPtr->getValue()));
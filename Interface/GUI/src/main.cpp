@@ -57,6 +57,8 @@ int main(int argc, char *argv[]) {
                     controller.clearScreen();
                 } else if (event.key.code == sf::Keyboard::R) {
                     controller.execute();
+                } else if (event.key.code == sf::Keyboard::C) {
+                    controller.cancel();
                 }
             } else if (event.type == sf::Event::TextEntered) {
                 controller.appendChar(static_cast<char>(event.text.unicode));
@@ -71,6 +73,7 @@ int main(int argc, char *argv[]) {
             }
         }
 
+        controller.update();
         controller.drawToWindows();
         textWindow.display();
         drawingBoard.display();
@@ -25,6 +25,7 @@ TEST(DrawingBoardTest, drawPointTest) {
     string code{"(#painter (list (cons 5 5)))"};
     for (char c: code) controller.appendChar(c);
     controller.execute();
+    controller.wait();
     controller.drawToWindows();
 }
 
@@ -41,6 +42,7 @@ TEST(DrawingBoardTest, drawMultiplePointTest) {
     string code{"(#painter (list (cons 5 5) (cons 50 50) (cons 500 500)))"};
     for (char c: code) controller.appendChar(c);
     controller.execute();
+    controller.wait();
     controller.drawToWindows();
 }
 
@@ -56,6 +58,7 @@ TEST(DrawingBoardTest, drawLineTest) {
     string code{"(#painter (line (cons 5 5) (cons 5 100)))"};
     for (char c: code) controller.appendChar(c);
     controller.execute();
+    controller.wait();
     controller.drawToWindows();
 }
 
@@ -71,5 +74,6 @@ TEST(DrawingBoardTest, drawLineTestV2) {
     string code{"(#painter (line (cons 5 5) (cons 100 100)))"};
     for (char c: code) controller.appendChar(c);
     controller.execute();
+    controller.wait();
     controller.drawToWindows();
 }
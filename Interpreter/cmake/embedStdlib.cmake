@@ -0,0 +1,25 @@
+# Generate a translation unit holding the Scheme stdlib as static data.
+# Usage: cmake -DSTDLIB_DIR=<dir> -DSTDLIB_FILES=<a.scm,b.scm> -DOUTPUT=<file.cpp> -P embedStdlib.cmake
+
+set(DELIMITER "LSI_STDLIB")
+string(REPLACE "," ";" STDLIB_FILES "${STDLIB_FILES}")
+
+file(WRITE ${OUTPUT}.tmp
+        "// Generated by embedStdlib.cmake from ${STDLIB_DIR}. Do not edit.\n"
+        "#include <embeddedLib.h>\n\n"
+        "const std::vector<std::pair<std::string, std::string>> &embedded::libraries() {\n"
+        "    static const std::vector<std::pair<std::string, std::string>> libs = {\n")
+
+foreach (LIB ${STDLIB_FILES})
+    file(READ ${STDLIB_DIR}/${LIB} CONTENT)
+    file(APPEND ${OUTPUT}.tmp "        {\"${LIB}\", R\"${DELIMITER}(${CONTENT})${DELIMITER}\"},\n")
+endforeach (LIB)
+
+file(APPEND ${OUTPUT}.tmp
+        "    };\n"
+        "    return libs;\n"
+        "}\n")
+
+# Only touch the output when the content changes, so the library is not rebuilt needlessly.
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
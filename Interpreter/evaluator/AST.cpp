@@ -1,15 +1,35 @@
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <parser.h>
+#include <arena.h>
 #include <exception.h>
 #include <visitor.h>
+#include <optimizer.h>
+#include <escape.h>
 #include <AST.h>
 #include <context.h>
+#include <framePool.h>
+#include <internTable.h>
+#include <tracer.h>
 
 using namespace parser;
 using namespace exception;
 using namespace ast;
 using namespace visitor;
+using namespace profiler;
+
+namespace {
+    // Short description of a top-level form in trace
+    std::string describe(const pExpr &expr) {
+        if (expr->kind() == NodeKind::VALUE_BINDING || expr->kind() == NodeKind::LAMBDA_BINDING)
+            return "define " + std::static_pointer_cast<BindingAST>(expr)->getIdentifier();
+        if (auto invocation = nodeAs<InvocationAST>(expr))
+            if (auto id = nodeAs<IdentifierAST>(invocation->getCallable()))
+                return "(" + id->getId() + " ...)";
+        return "form";
+    }
+}
 
 void LambdaBindingAST::accept(visitor::NodeVisitor &visitor) const {
     visitor.visitLambdaBindingAST(*this);
@@ -25,7 +45,7 @@ std::shared_ptr<ExprAST> ValueBindingAST::eval(std::shared_ptr<Scope> &ss) const
 }
 
 void ValueBindingAST::accept(visitor::NodeVisitor &visitor) const {
-    visitor.visitBindingAST(*this);
+    visitor.visitValueBindingAST(*this);
 }
 
 pExpr ValueBindingAST::getPointer() const {
@@ -33,7 +53,7 @@ pExpr ValueBindingAST::getPointer() const {
 }
 
 ValueBindingAST::ValueBindingAST(const std::string &id, const std::shared_ptr<ExprAST> &v)
-    : BindingAST(id), value{v} {}
+    : BindingAST(id, KIND), value{v} {}
 
 std::shared_ptr<ExprAST> ExprAST::eval(std::shared_ptr<Scope> &) const {
     return getPointer();
@@ -52,18 +72,26 @@ void ExprAST::accept(visitor::NodeVisitor &visitor) const {
 }
 
 std::shared_ptr<ExprAST> LoadingFileAST::eval(std::shared_ptr<Scope> &s) const {
+    TraceScope trace{"load", "load"};
+    trace.setDetail(filename);
     std::ifstream fin{filename};
     std::string str{std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
-    lexers::Lexer lex{str};
-    auto ptr = parseAllExpr(lex);
+    lexers::Lexer lex;
+    lex.setName(filename);
+    lex.appendExp(str);
+    auto ptr = optimize(parseAllExpr(lex));
     return ptr->eval(s);
 }
 
 std::vector<pExpr> LoadingFileAST::evalAll(std::shared_ptr<Scope> &s) const {
+    TraceScope trace{"load", "load"};
+    trace.setDetail(filename);
     std::ifstream fin{filename};
     std::string str{std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
-    lexers::Lexer lex{str};
-    auto ptr = std::dynamic_pointer_cast<AllExprAST>(parseAllExpr(lex));
+    lexers::Lexer lex;
+    lex.setName(filename);
+    lex.appendExp(str);
+    auto ptr = nodeCast<AllExprAST>(optimize(parseAllExpr(lex)));
     return ptr->evalAll(s);
 }
 
@@ -93,15 +121,13 @@ void NumberAST::accept(visitor::NodeVisitor &visitor) const {
 }
 
 pExpr NumberAST::getPointer() const {
-    return std::make_shared<NumberAST>(*this);
+    return context::InternTable::number(value);
 }
 
 std::shared_ptr<ExprAST> IdentifierAST::eval(std::shared_ptr<Scope> &ss) const {
-    if (ss->count(getId())) {
-        return ss->findSymbol(getId());
-    } else {
-        throw UnboundIdentifier("Unbound identifier: " + getId());
-    }
+    auto ret = ss->findSymbol(getId());
+    if (!ret) throw UnboundIdentifier("Unbound identifier: " + getId());
+    return ret;
 }
 
 void IdentifierAST::accept(visitor::NodeVisitor &visitor) const {
@@ -122,7 +148,11 @@ pExpr InvocationAST::getPointer() const {
 }
 
 InvocationAST::InvocationAST(const std::shared_ptr<ExprAST> &lam, const std::vector<std::shared_ptr<ExprAST>> &args)
-    : callableObj{lam}, actualArgs{args} {
+    : ExprAST(KIND), callableObj{lam}, actualArgs{args} {
+    if (auto id = nodeAs<IdentifierAST>(lam)) {
+        auto it = Scope::builtinFunc.find(id->getId());
+        if (it != Scope::builtinFunc.end()) builtin = it->second;
+    }
 }
 
 void BooleansTrueAST::accept(visitor::NodeVisitor &visitor) const {
@@ -159,18 +189,20 @@ pExpr AllExprAST::getPointer() const {
 std::vector<pExpr> AllExprAST::evalAll(std::shared_ptr<Scope> &s) const {
     std::vector<pExpr> ret;
     for (auto ptr : exprVec)
-        if (auto load = std::dynamic_pointer_cast<LoadingFileAST>(ptr)) {
+        if (auto load = nodeAs<LoadingFileAST>(ptr)) {
             auto vec = load->evalAll(s);
             ret.insert(std::end(ret), std::begin(vec), std::end(vec));
         } else {
+            TraceScope trace{"eval", "top-level form"};
             ret.push_back(ptr->eval(s));
+            if (trace.sampled()) trace.setDetail(describe(ptr));
         }
     return std::move(ret);
 }
 
 std::shared_ptr<ExprAST> PairAST::eval(std::shared_ptr<Scope> &s) const {
     // Attention: since the evaluation may depends on context, never store those result.
-    return std::make_shared<PairAST>(data.first->eval(s), data.second->eval(s));
+    return context::InternTable::pair(data.first->eval(s), data.second->eval(s));
 }
 
 void PairAST::accept(visitor::NodeVisitor &visitor) const {
@@ -178,7 +210,7 @@ void PairAST::accept(visitor::NodeVisitor &visitor) const {
 }
 
 pExpr PairAST::getPointer() const {
-    return std::make_shared<PairAST>(*this);
+    return context::InternTable::pair(data.first, data.second);
 }
 
 void LambdaAST::accept(visitor::NodeVisitor &visitor) const {
@@ -189,8 +221,22 @@ pExpr LambdaAST::getPointer() const {
     return std::make_shared<LambdaAST>(*this);
 }
 
-LambdaAST::LambdaAST(std::vector<std::string> v, std::vector<std::shared_ptr<ExprAST>> expr)
-    : formalArgs{std::move(v)}, expression{std::move(expr)}, context{new Scope} {}
+LambdaAST::LambdaAST(std::vector<std::string> v, std::vector<std::shared_ptr<ExprAST>> expr, std::string loc)
+    : ExprAST(KIND) {
+    // Analyzed once here, closures made by eval share the result
+    auto c = std::make_shared<Code>();
+    c->formalArgs = std::move(v);
+    c->expression = std::move(expr);
+    c->location = std::move(loc);
+    c->hasSubroutine = std::any_of(c->expression.begin(), c->expression.end(), [](const pExpr &expr) {
+        return nodeAs<LambdaBindingAST>(expr) != nullptr;
+    });
+    code = c;
+    auto dot = std::find(c->formalArgs.begin(), c->formalArgs.end(), ".");
+    c->restView = dot != c->formalArgs.end() && dot + 1 != c->formalArgs.end()
+                  && !visitor::EscapeVisitor::restEscapes(*this);
+    c->flat = !c->hasSubroutine && visitor::CaptureVisitor::freeVariables(*this, c->freeVariables);
+}
 
 
 void NilAST::accept(visitor::NodeVisitor &visitor) const {
@@ -201,12 +247,41 @@ pExpr NilAST::getPointer() const {
     return std::make_shared<NilAST>(*this);
 }
 
+void VectorAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitVectorAST(*this);
+}
+
+pExpr VectorAST::getPointer() const {
+    return std::make_shared<VectorAST>(*this);
+}
+
+pExpr RestArgsAST::rest() const {
+    // Shared, nil can't be changed
+    static const pExpr nil = std::make_shared<NilAST>();
+    if (offset + 1 == args->size()) return nil;
+    return std::make_shared<RestArgsAST>(args, offset + 1);
+}
+
+pExpr RestArgsAST::toList() const {
+    pExpr ret = std::make_shared<NilAST>();
+    for (auto i = args->size(); i > offset; i--) ret = context::InternTable::pair((*args)[i - 1], ret);
+    return ret;
+}
+
+void RestArgsAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitRestArgsAST(*this);
+}
+
+pExpr RestArgsAST::getPointer() const {
+    return std::make_shared<RestArgsAST>(*this);
+}
+
 
 CondStatementAST::CondStatementAST(const std::vector<std::shared_ptr<ExprAST>> &condition,
                                    const std::vector<std::shared_ptr<ExprAST>> &result)
-    : ifStatement{std::make_shared<BooleansFalseAST>()} {
+    : ifStatement{makeNode<BooleansFalseAST>()} {
     for (int index = static_cast<int>(condition.size() - 1); index >= 0; index--)
-        ifStatement = std::make_shared<IfStatementAST>(condition[index], result[index], ifStatement);
+        ifStatement = makeNode<IfStatementAST>(condition[index], result[index], ifStatement);
 }
 
 std::shared_ptr<ExprAST> CondStatementAST::eval(std::shared_ptr<Scope> &s) const {
@@ -238,12 +313,14 @@ pExpr BindingAST::getPointer() const {
 }
 
 std::shared_ptr<ExprAST> LetStatementAST::eval(std::shared_ptr<Scope> &s) const {
-    auto tmp = std::make_shared<Scope>();
+    auto tmp = context::FramePool::scope();
     tmp->setDynamicScope(s);
     for (auto index = 0; index < identifier.size(); index++) {
-        auto id = std::dynamic_pointer_cast<IdentifierAST>(identifier[index])->getId();
-        tmp->addSymbol(id, value[index]->eval(s));
+        auto id = nodeAs<IdentifierAST>(identifier[index])->getId();
+        tmp->addParam(id, value[index]->eval(s));
     }
-    return expr->eval(tmp);
+    auto ret = expr->eval(tmp);
+    context::FramePool::recycle(tmp);
+    return ret;
 }
 
@@ -0,0 +1,56 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#define malloc_usable_size malloc_size
+#else
+#include <malloc.h>
+#endif
+#include <profiler.h>
+
+// Global allocation counting for the profiler. It lives in the same translation unit as
+// profiler::allocationCount(), so it's linked whenever the profiler is.
+
+namespace {
+    thread_local std::size_t allocations = 0;
+    thread_local long long balance = 0;
+    // Number of AllocationCounting that are on
+    std::atomic<int> counting{0};
+}
+
+profiler::AllocationCounting::AllocationCounting(bool on) : on{on} {
+    if (on) counting.fetch_add(1, std::memory_order_relaxed);
+}
+
+profiler::AllocationCounting::~AllocationCounting() {
+    if (on) counting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::size_t profiler::allocationCount() {
+    return allocations;
+}
+
+long long profiler::heapBalance() {
+    return balance;
+}
+
+void *operator new(std::size_t size) {
+    auto count = counting.load(std::memory_order_relaxed) > 0;
+    if (count) ++allocations;
+    if (size == 0) size = 1;
+    while (true) {
+        if (auto p = std::malloc(size)) {
+            if (count) balance += malloc_usable_size(p);
+            return p;
+        }
+        auto handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void *p) noexcept {
+    if (p && counting.load(std::memory_order_relaxed) > 0) balance -= malloc_usable_size(p);
+    std::free(p);
+}
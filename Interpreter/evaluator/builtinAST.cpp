@@ -1,4 +1,7 @@
+#include <cmath>
 #include <fstream>
+#include <iostream>
+#include <limits>
 #include <sstream>
 #include <parser.h>
 #include <exception.h>
@@ -6,12 +9,72 @@
 #include <AST.h>
 #include <builtinAST.h>
 #include <context.h>
+#include <evalLimits.h>
+#include <memstats.h>
+#include <internTable.h>
 
 using namespace parser;
 using namespace exception;
 using namespace ast;
 using namespace visitor;
 
+namespace {
+    void checkArgs(const std::vector<pExpr> &actualArgs, size_t n, const std::string &name) {
+        if (actualArgs.size() != n)
+            throw RuntimeError(name + " expects " + std::to_string(n) + " argument(s), got " +
+                               std::to_string(actualArgs.size()));
+    }
+
+    // v itself, or the list it stands for if it's rest arguments
+    pExpr asList(const pExpr &v) {
+        if (auto view = nodeAs<RestArgsAST>(v)) return view->toList();
+        return v;
+    }
+
+    // Elements of a proper list
+    std::vector<pExpr> toVector(pExpr list, const std::string &name) {
+        list = asList(list);
+        std::vector<pExpr> elements;
+        while (auto p = nodeAs<PairAST>(list)) {
+            elements.push_back(p->data.first);
+            list = p->data.second;
+        }
+        if (!nodeAs<NilAST>(list)) throw NotPair(name + ": argument is not a list");
+        return elements;
+    }
+
+    // List of elements in [first, last) in front of tail
+    template<class Iter>
+    pExpr toList(Iter first, Iter last, pExpr tail) {
+        while (last != first) tail = context::InternTable::pair(*--last, tail);
+        return tail;
+    }
+
+    std::shared_ptr<VectorAST> toVectorAST(const pExpr &v, const std::string &name) {
+        if (auto p = nodeCast<VectorAST>(v)) return p;
+        throw RuntimeError(name + ": argument is not a vector");
+    }
+
+    // Non-negative integer; what names it in errors
+    size_t toIndex(const pExpr &n, const std::string &name, const std::string &what = "index") {
+        auto p = nodeAs<NumberAST>(n);
+        if (!p) throw NotNumber(name + ": " + what + " is not a number");
+        auto i = p->getValue();
+        // Casting a negative, NaN or too big value is undefined, so the range is checked first
+        if (!(i >= 0 && i < std::ldexp(1.0, std::numeric_limits<size_t>::digits)) || i != std::floor(i))
+            throw RuntimeError(name + ": " + what + " is not a non-negative integer");
+        return static_cast<size_t>(i);
+    }
+
+    // Call function value f from a builtin, as InvocationAST calls a callee that isn't an identifier
+    pExpr call(const pExpr &f, const std::vector<pExpr> &args, pScope &s) {
+        context::LimitGuard::step();
+        auto lambda = nodeAs<LambdaAST>(f);
+        s->stepIntoAnonymousFunc(lambda ? lambda->getLocation() : "");
+        return f->apply(args, s);
+    }
+}
+
 void BuiltinDrawAST::accept(visitor::NodeVisitor &visitor) const {
     visitor.visitBuiltinDrawAST(*this);
 }
@@ -24,7 +87,7 @@ pExpr BuiltinDrawAST::getPointer() const {
 pExpr BuiltinNullAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
 
     s->stepOutFunc();
-    if (auto p = std::dynamic_pointer_cast<NilAST>(actualArgs.front()))
+    if (nodeAs<NilAST>(actualArgs.front()))
         return std::make_shared<BooleansTrueAST>();
     else
         return std::make_shared<BooleansFalseAST>();
@@ -39,9 +102,9 @@ pExpr BuiltinNullAST::getPointer() const {
 }
 
 pExpr BuiltinOppositeAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
-    if (auto p = std::dynamic_pointer_cast<NumberAST>(actualArgs.front())) {
+    if (auto p = nodeAs<NumberAST>(actualArgs.front())) {
         s->stepOutFunc();
-        return std::make_shared<NumberAST>(-p->getValue());
+        return context::InternTable::number(-p->getValue());
     } else {
         throw NotNumber("The operands cannot be converted to number");
     }
@@ -58,7 +121,7 @@ pExpr BuiltinOppositeAST::getPointer() const {
 pExpr BuiltinListAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
     std::shared_ptr<ExprAST> list = std::make_shared<NilAST>();
     for (int i = static_cast<int>(actualArgs.size() - 1); i >= 0; i--)
-        list = std::make_shared<PairAST>(actualArgs[i], list);
+        list = context::InternTable::pair(actualArgs[i], list);
 
     s->stepOutFunc();
     return list;
@@ -76,10 +139,10 @@ pExpr BuiltinListAST::getPointer() const {
 pExpr BuiltinLessThanAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
     bool res = std::is_sorted(
         std::begin(actualArgs), std::end(actualArgs),
-        [&](std::shared_ptr<ExprAST> p1, std::shared_ptr<ExprAST> p2) {
+        [&](const std::shared_ptr<ExprAST> &p1, const std::shared_ptr<ExprAST> &p2) {
             //[&](decltype(actualArgs)::value_type p1, decltype(actualArgs)::value_type p2) {
-            auto np1 = std::dynamic_pointer_cast<NumberAST>(p1);
-            auto np2 = std::dynamic_pointer_cast<NumberAST>(p2);
+            auto np1 = nodeAs<NumberAST>(p1);
+            auto np2 = nodeAs<NumberAST>(p2);
             if (np1 && np2) {
                 // Important: if (comp(*next,*first)) return true then is_sorted return false
                 return np1->getValue() <= np2->getValue();
@@ -103,10 +166,13 @@ pExpr BuiltinLessThanAST::getPointer() const {
 
 
 pExpr BuiltinCarAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
-    if (auto p = std::dynamic_pointer_cast<PairAST>(actualArgs.front())) {
+    if (auto p = nodeAs<PairAST>(actualArgs.front())) {
 
         s->stepOutFunc();
         return p->data.first;
+    } else if (auto view = nodeAs<RestArgsAST>(actualArgs.front())) {
+        s->stepOutFunc();
+        return view->first();
     } else {
         throw NotPair("Cannot convert to pair");
     }
@@ -121,10 +187,13 @@ pExpr BuiltinCarAST::getPointer() const {
 }
 
 pExpr BuiltinCdrAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
-    if (auto p = std::dynamic_pointer_cast<PairAST>(actualArgs.front())) {
+    if (auto p = nodeAs<PairAST>(actualArgs.front())) {
 
         s->stepOutFunc();
         return p->data.second;
+    } else if (auto view = nodeAs<RestArgsAST>(actualArgs.front())) {
+        s->stepOutFunc();
+        return view->rest();
     } else {
         throw NotPair("Cannot convert to pair");
     }
@@ -140,7 +209,7 @@ pExpr BuiltinCdrAST::getPointer() const {
 
 pExpr BuiltinConsAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
     if (actualArgs.size() == 2) {
-        auto p = std::make_shared<PairAST>(actualArgs[0]->eval(s), actualArgs[1]->eval(s));
+        auto p = context::InternTable::pair(actualArgs[0]->eval(s), actualArgs[1]->eval(s));
         s->stepOutFunc();
         return p;
     } else {
@@ -158,15 +227,15 @@ pExpr BuiltinConsAST::getPointer() const {
 
 pExpr BuiltinAddAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
     double num = 0;
-    for (auto res: actualArgs) {
-        if (auto p = std::dynamic_pointer_cast<NumberAST>(res)) {
+    for (const auto &res: actualArgs) {
+        if (auto p = nodeAs<NumberAST>(res)) {
             num += p->getValue();
         } else {
             throw NotNumber("The operands cannot be converted to number");
         }
     }
     s->stepOutFunc();
-    return std::make_shared<NumberAST>(num);
+    return context::InternTable::number(num);
 }
 
 void BuiltinAddAST::accept(visitor::NodeVisitor &visitor) const {
@@ -179,15 +248,15 @@ pExpr BuiltinAddAST::getPointer() const {
 
 pExpr BuiltinMultiplyAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
     double num = 1;
-    for (auto res: actualArgs) {
-        if (auto p = std::dynamic_pointer_cast<NumberAST>(res)) {
+    for (const auto &res: actualArgs) {
+        if (auto p = nodeAs<NumberAST>(res)) {
             num *= p->getValue();
         } else {
             throw NotNumber("The operands cannot be converted to number");
         }
     }
     s->stepOutFunc();
-    return std::make_shared<NumberAST>(num);
+    return context::InternTable::number(num);
 }
 
 void BuiltinMultiplyAST::accept(visitor::NodeVisitor &visitor) const {
@@ -200,10 +269,10 @@ pExpr BuiltinMultiplyAST::getPointer() const {
 
 pExpr
 BuiltinReciprocalAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
-    if (auto p = std::dynamic_pointer_cast<NumberAST>(actualArgs.front())) {
+    if (auto p = nodeAs<NumberAST>(actualArgs.front())) {
 
         s->stepOutFunc();
-        return std::make_shared<NumberAST>(1 / p->getValue());
+        return context::InternTable::number(1 / p->getValue());
     } else {
         throw NotNumber("The operands cannot be converted to number");
     }
@@ -216,3 +285,336 @@ void BuiltinReciprocalAST::accept(visitor::NodeVisitor &visitor) const {
 pExpr BuiltinReciprocalAST::getPointer() const {
     return std::make_shared<BuiltinReciprocalAST>(*this);
 }
+
+pExpr BuiltinMemStatsAST::apply(const std::vector<pExpr> &, pScope &s) const {
+    if (profiler::MemoryStats::enabled)
+        profiler::MemoryStats::report(std::cerr);
+    else
+        std::cerr << "Memory statistics are disabled, run with --mem-stats" << std::endl;
+    s->stepOutFunc();
+    return context::InternTable::number(profiler::MemoryStats::live());
+}
+
+void BuiltinMemStatsAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinMemStatsAST(*this);
+}
+
+pExpr BuiltinMemStatsAST::getPointer() const {
+    return std::make_shared<BuiltinMemStatsAST>(*this);
+}
+
+pExpr BuiltinMapAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 2, "map");
+    auto elements = toVector(actualArgs[0], "map");
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it)
+        *it = call(actualArgs[1], {*it}, s);
+    s->stepOutFunc();
+    return toList(elements.begin(), elements.end(), std::make_shared<NilAST>());
+}
+
+void BuiltinMapAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinMapAST(*this);
+}
+
+pExpr BuiltinMapAST::getPointer() const {
+    return std::make_shared<BuiltinMapAST>(*this);
+}
+
+pExpr BuiltinAppendAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    if (actualArgs.empty()) throw RuntimeError("append expects at least 1 argument, got 0");
+    std::vector<pExpr> elements;
+    for (size_t i = 0; i + 1 < actualArgs.size(); i++) {
+        auto list = toVector(actualArgs[i], "append");
+        elements.insert(elements.end(), list.begin(), list.end());
+    }
+    s->stepOutFunc();
+    return toList(elements.begin(), elements.end(), actualArgs.back());
+}
+
+void BuiltinAppendAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinAppendAST(*this);
+}
+
+pExpr BuiltinAppendAST::getPointer() const {
+    return std::make_shared<BuiltinAppendAST>(*this);
+}
+
+pExpr BuiltinReverseAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 1, "reverse");
+    pExpr list = asList(actualArgs[0]), res = std::make_shared<NilAST>();
+    while (auto p = nodeAs<PairAST>(list)) {
+        res = context::InternTable::pair(p->data.first, res);
+        list = p->data.second;
+    }
+    if (!nodeAs<NilAST>(list)) throw NotPair("reverse: argument is not a list");
+    s->stepOutFunc();
+    return res;
+}
+
+void BuiltinReverseAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinReverseAST(*this);
+}
+
+pExpr BuiltinReverseAST::getPointer() const {
+    return std::make_shared<BuiltinReverseAST>(*this);
+}
+
+pExpr BuiltinLengthAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 1, "length");
+    double n = 0;
+    pExpr list = asList(actualArgs[0]);
+    for (; auto p = nodeAs<PairAST>(list); n++) list = p->data.second;
+    if (!nodeAs<NilAST>(list)) throw NotPair("length: argument is not a list");
+    s->stepOutFunc();
+    return context::InternTable::number(n);
+}
+
+void BuiltinLengthAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinLengthAST(*this);
+}
+
+pExpr BuiltinLengthAST::getPointer() const {
+    return std::make_shared<BuiltinLengthAST>(*this);
+}
+
+pExpr BuiltinReduceAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 3, "reduce");
+    auto res = actualArgs[2];
+    pExpr list = asList(actualArgs[0]);
+    while (auto p = nodeAs<PairAST>(list)) {
+        res = call(actualArgs[1], {res, p->data.first}, s);
+        list = p->data.second;
+    }
+    if (!nodeAs<NilAST>(list)) throw NotPair("reduce: argument is not a list");
+    s->stepOutFunc();
+    return res;
+}
+
+void BuiltinReduceAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinReduceAST(*this);
+}
+
+pExpr BuiltinReduceAST::getPointer() const {
+    return std::make_shared<BuiltinReduceAST>(*this);
+}
+
+pExpr BuiltinFilterAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 2, "filter");
+    std::vector<pExpr> kept;
+    for (auto &x : toVector(actualArgs[0], "filter"))
+        if (!nodeAs<BooleansFalseAST>(call(actualArgs[1], {x}, s)))
+            kept.push_back(x);
+    s->stepOutFunc();
+    return toList(kept.begin(), kept.end(), std::make_shared<NilAST>());
+}
+
+void BuiltinFilterAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinFilterAST(*this);
+}
+
+pExpr BuiltinFilterAST::getPointer() const {
+    return std::make_shared<BuiltinFilterAST>(*this);
+}
+
+pExpr BuiltinMakeVectorAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    if (actualArgs.size() != 1 && actualArgs.size() != 2)
+        throw RuntimeError("make-vector expects 1 or 2 arguments, got " + std::to_string(actualArgs.size()));
+    auto n = toIndex(actualArgs[0], "make-vector");
+    if (n > std::vector<pExpr>().max_size()) throw RuntimeError("make-vector: size is too big");
+    context::LimitGuard::reserve(n * sizeof(pExpr));
+    pExpr fill = actualArgs.size() == 2 ? actualArgs[1] : context::InternTable::number(0);
+    s->stepOutFunc();
+    return std::make_shared<VectorAST>(std::vector<pExpr>(n, fill));
+}
+
+void BuiltinMakeVectorAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinMakeVectorAST(*this);
+}
+
+pExpr BuiltinMakeVectorAST::getPointer() const {
+    return std::make_shared<BuiltinMakeVectorAST>(*this);
+}
+
+pExpr BuiltinVectorAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    s->stepOutFunc();
+    return std::make_shared<VectorAST>(actualArgs);
+}
+
+void BuiltinVectorAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinVectorAST(*this);
+}
+
+pExpr BuiltinVectorAST::getPointer() const {
+    return std::make_shared<BuiltinVectorAST>(*this);
+}
+
+pExpr BuiltinVectorRefAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 2, "vector-ref");
+    auto &elements = *toVectorAST(actualArgs[0], "vector-ref")->elements;
+    auto i = toIndex(actualArgs[1], "vector-ref");
+    if (i >= elements.size()) throw RuntimeError("vector-ref: index out of range");
+    s->stepOutFunc();
+    return elements[i];
+}
+
+void BuiltinVectorRefAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinVectorRefAST(*this);
+}
+
+pExpr BuiltinVectorRefAST::getPointer() const {
+    return std::make_shared<BuiltinVectorRefAST>(*this);
+}
+
+pExpr BuiltinVectorSetAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 3, "vector-set!");
+    auto &elements = *toVectorAST(actualArgs[0], "vector-set!")->elements;
+    auto i = toIndex(actualArgs[1], "vector-set!");
+    if (i >= elements.size()) throw RuntimeError("vector-set!: index out of range");
+    elements[i] = actualArgs[2];
+    s->stepOutFunc();
+    // Unspecified, displayed as nothing
+    return std::make_shared<ExprAST>();
+}
+
+void BuiltinVectorSetAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinVectorSetAST(*this);
+}
+
+pExpr BuiltinVectorSetAST::getPointer() const {
+    return std::make_shared<BuiltinVectorSetAST>(*this);
+}
+
+pExpr BuiltinVectorLengthAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 1, "vector-length");
+    auto n = toVectorAST(actualArgs[0], "vector-length")->elements->size();
+    s->stepOutFunc();
+    return context::InternTable::number(n);
+}
+
+void BuiltinVectorLengthAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinVectorLengthAST(*this);
+}
+
+pExpr BuiltinVectorLengthAST::getPointer() const {
+    return std::make_shared<BuiltinVectorLengthAST>(*this);
+}
+
+pExpr BuiltinVectorMapAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 2, "vector-map");
+    auto elements = *toVectorAST(actualArgs[0], "vector-map")->elements;
+    for (auto &x : elements) x = call(actualArgs[1], {x}, s);
+    s->stepOutFunc();
+    return std::make_shared<VectorAST>(std::move(elements));
+}
+
+void BuiltinVectorMapAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinVectorMapAST(*this);
+}
+
+pExpr BuiltinVectorMapAST::getPointer() const {
+    return std::make_shared<BuiltinVectorMapAST>(*this);
+}
+
+pExpr BuiltinVectorToListAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 1, "vector->list");
+    auto &elements = *toVectorAST(actualArgs[0], "vector->list")->elements;
+    s->stepOutFunc();
+    return toList(elements.begin(), elements.end(), std::make_shared<NilAST>());
+}
+
+void BuiltinVectorToListAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinVectorToListAST(*this);
+}
+
+pExpr BuiltinVectorToListAST::getPointer() const {
+    return std::make_shared<BuiltinVectorToListAST>(*this);
+}
+
+pExpr BuiltinListToVectorAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 1, "list->vector");
+    auto elements = toVector(actualArgs[0], "list->vector");
+    s->stepOutFunc();
+    return std::make_shared<VectorAST>(std::move(elements));
+}
+
+void BuiltinListToVectorAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinListToVectorAST(*this);
+}
+
+pExpr BuiltinListToVectorAST::getPointer() const {
+    return std::make_shared<BuiltinListToVectorAST>(*this);
+}
+
+pExpr BuiltinEqualAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 2, "equal?");
+    s->stepOutFunc();
+    if (context::InternTable::equal(actualArgs[0].get(), actualArgs[1].get()))
+        return std::make_shared<BooleansTrueAST>();
+    return std::make_shared<BooleansFalseAST>();
+}
+
+void BuiltinEqualAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinEqualAST(*this);
+}
+
+pExpr BuiltinEqualAST::getPointer() const {
+    return std::make_shared<BuiltinEqualAST>(*this);
+}
+
+pExpr MemoizedAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    std::size_t hash;
+    if (!context::MemoCache::key(actualArgs, hash)) {
+        cache->uncached();
+        return function->apply(actualArgs, s);
+    }
+    if (auto ret = cache->find(actualArgs, hash)) {
+        s->stepOutFunc();
+        return ret;
+    }
+    // f removes the record of this call as it returns
+    auto ret = function->apply(actualArgs, s);
+    cache->insert(actualArgs, hash, ret);
+    return ret;
+}
+
+void MemoizedAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitMemoizedAST(*this);
+}
+
+pExpr MemoizedAST::getPointer() const {
+    return std::make_shared<MemoizedAST>(*this);
+}
+
+pExpr BuiltinMemoizeAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    if (actualArgs.empty() || actualArgs.size() > 2)
+        throw RuntimeError("memoize expects 1 or 2 argument(s), got " + std::to_string(actualArgs.size()));
+    auto capacity = context::MemoCache::DEFAULT_CAPACITY;
+    if (actualArgs.size() == 2) capacity = toIndex(actualArgs[1], "memoize", "capacity");
+    s->stepOutFunc();
+    return std::make_shared<MemoizedAST>(actualArgs[0], capacity);
+}
+
+void BuiltinMemoizeAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinMemoizeAST(*this);
+}
+
+pExpr BuiltinMemoizeAST::getPointer() const {
+    return std::make_shared<BuiltinMemoizeAST>(*this);
+}
+
+pExpr BuiltinMemoStatsAST::apply(const std::vector<pExpr> &actualArgs, pScope &s) const {
+    checkArgs(actualArgs, 1, "memo-stats");
+    auto f = nodeAs<MemoizedAST>(actualArgs[0]);
+    if (!f) throw RuntimeError("memo-stats: argument is not a memoized function");
+    s->stepOutFunc();
+    return context::InternTable::pair(context::InternTable::number(f->getCache().hits()),
+                                      context::InternTable::number(f->getCache().misses()));
+}
+
+void BuiltinMemoStatsAST::accept(visitor::NodeVisitor &visitor) const {
+    visitor.visitBuiltinMemoStatsAST(*this);
+}
+
+pExpr BuiltinMemoStatsAST::getPointer() const {
+    return std::make_shared<BuiltinMemoStatsAST>(*this);
+}
@@ -4,11 +4,15 @@
 #include <builtinAST.h>
 #include <parser.h>
 #include <context.h>
+#include <inlineCache.h>
 #include <stack>
 #include <exception.h>
+#include <profiler.h>
+#include <log.h>
 
 using namespace std;
 using namespace ast;
+using namespace profiler;
 
 namespace context {
 
@@ -17,81 +21,164 @@ namespace context {
     }
 
 
+    namespace {
+        void markParent(Scope *scope) {
+            // Loaded first, so that calls from a shared parent don't all write to it
+            if (scope && !scope->hasChildren.load(std::memory_order_relaxed))
+                scope->hasChildren.store(true, std::memory_order_relaxed);
+        }
+    }
+
     void Scope::setDynamicScope(const std::shared_ptr<Scope> &scope) {
+        markParent(scope.get());
         dynamicScope = scope;
     }
 
     void Scope::setLexicalScope(const std::shared_ptr<Scope> &scope) {
+        markParent(scope.get());
         lexicalScope = scope;
     }
 
     void Scope::clearCurScope() {
+        serial = InlineCache::stamp();
+        hasChildren.store(false, std::memory_order_relaxed);
         symtab.clear();
+        for (std::size_t i = 0; i < paramCount; i++) params[i].second = nullptr;
+        paramCount = 0;
     }
 
     void Scope::addBuiltinFunc(const std::string &name, const std::shared_ptr<ast::ExprAST> &expr) {
         symtab[name] = expr;
+        InlineCache::invalidate();
     }
 
     pExpr Scope::findSymbol(const std::string &id) const {
-        if (builtinFunc.count(id)) return builtinFunc.find(id)->second;
-        if (symtab.count(id)) return symtab.find(id)->second;
-
-        pExpr ret = nullptr;
+        auto builtin = builtinFunc.find(id);
+        if (builtin != builtinFunc.end()) return builtin->second;
+        pExpr ret = findLocal(id);
+        if (ret) return ret;
         if (lexicalScope && ((ret = lexicalScope->findSymbol(id)) != nullptr))
             return ret;
-        if (dynamicScope && ((ret = dynamicScope->findSymbol(id)) != nullptr))
+        if (dynamicScope && ((ret = dynamicScope->findSymbol(id)) != nullptr)) {
+            // Rest arguments of a caller are a view only to the caller itself, see visitor::EscapeVisitor
+            if (auto view = nodeAs<RestArgsAST>(ret)) return view->toList();
             return ret;
+        }
         return ret;
     }
 
+    pExpr Scope::findLocal(const std::string &id) const {
+        auto ret = findParam(id);
+        if (ret) return ret;
+        if (!symtab.empty()) {
+            auto it = symtab.find(id);
+            if (it != symtab.end()) return it->second;
+        }
+        return nullptr;
+    }
+
+    pExpr Scope::findParam(const std::string &id) const {
+        // The last one wins if a name is repeated, like in symtab
+        for (auto i = paramCount; i > 0; i--)
+            if (params[i - 1].first == id) return params[i - 1].second;
+        return nullptr;
+    }
+
     void Scope::addSymbol(const std::string &id, pExpr ptr) {
-        symtab[id] = ptr;
+        // E.g. internal definitions of a call, made before it calls anything, are seen by no cache
+        if (hasChildren.load(std::memory_order_relaxed)) InlineCache::invalidate();
+        // Redefine a parameter in place, otherwise the parameter would hide the definition
+        for (auto i = paramCount; i > 0; i--)
+            if (params[i - 1].first == id) {
+                params[i - 1].second = std::move(ptr);
+                return;
+            }
+        symtab[id] = std::move(ptr);
+    }
+
+    void Scope::addParam(const std::string &id, pExpr ptr) {
+        if (paramCount == params.size()) {
+            params.emplace_back(id, std::move(ptr));
+        } else {
+            // Assigning to the old name reuses its buffer
+            params[paramCount].first = id;
+            params[paramCount].second = std::move(ptr);
+        }
+        paramCount++;
     }
 
-    std::stack<std::string> Scope::callTrace;
+    thread_local std::stack<std::string> Scope::callTrace;
 
-    int Scope::anonymousId;
+    thread_local int Scope::anonymousId;
 
 
     void Scope::stepIntoFunc(const std::string &name) {
-        CLOG(DEBUG, "context") << string(callTrace.size(), '|') << " /`"
-                               << "call [" << name << "] @ level " << callTrace.size() + 1;
+        DEBUG_LOG("context") << string(callTrace.size(), '|') << " /`"
+                             << "call [" << name << "] @ level " << callTrace.size() + 1;
         callTrace.push(name);
+        if (Profiler::enabled) Profiler::enter(name);
     }
 
     void Scope::stepOutFunc() {
-        CLOG(DEBUG, "context") << string(callTrace.size() - 1, '|') << " \\_"
-                               << "finish [" << callTrace.top() << "]" << " @ level " << callTrace.size();
+        DEBUG_LOG("context") << string(callTrace.size() - 1, '|') << " \\_"
+                             << "finish [" << callTrace.top() << "]" << " @ level " << callTrace.size();
         callTrace.pop();
+        if (Profiler::enabled) Profiler::leave();
     }
 
-    void Scope::stepIntoAnonymousFunc() {
-        stepIntoFunc("(anonymous #" + to_string(anonymousId++) + ")");
+    void Scope::stepIntoAnonymousFunc(const std::string &location) {
+        // Anonymous calls share one name in call trace, it never equals an identifier.
+        // The unique name is only built for log, and profiler merges calls of the same lambda.
+        static const std::string anonymous = "(anonymous)";
+        auto id = anonymousId++;
+        DEBUG_LOG("context") << string(callTrace.size(), '|') << " /`"
+                             << "call [(anonymous #" << id << (location.empty() ? "" : " @ " + location)
+                             << ")] @ level " << callTrace.size() + 1;
+        callTrace.push(anonymous);
+        if (Profiler::enabled) Profiler::enter(location.empty() ? "(lambda)" : "(lambda @ " + location + ")");
     }
 
-    std::string Scope::currentFunc() const {
-        if (callTrace.empty()) return "";
+    const std::string &Scope::currentFunc() const {
+        static const std::string none;
+        if (callTrace.empty()) return none;
         else return callTrace.top();
     }
 
-    Scope::Scope() {}
+    Scope::Scope() : serial{InlineCache::stamp()} {}
 
     // Attention: to add a builtin func, you have to:
     // 1. assure that any place where you make_shared<Builtin> invokes scope->stepInto()
     // 2. in its apply func, call scope->stepOut()
     const std::unordered_map<std::string, std::shared_ptr<ast::ExprAST>> Scope::builtinFunc = {
-        {"cons",        make_shared<BuiltinConsAST>()},
-        {"car",         make_shared<BuiltinCarAST>()},
-        {"cdr",         make_shared<BuiltinCdrAST>()},
-        {"+",           make_shared<BuiltinAddAST>()},
-        {"*",           make_shared<BuiltinMultiplyAST>()},
-        {"null?",       make_shared<BuiltinNullAST>()},
-        {"<",           make_shared<BuiltinLessThanAST>()},
-        {"#opposite",   make_shared<BuiltinOppositeAST>()},
-        {"#reciprocal", make_shared<BuiltinReciprocalAST>()},
-        {"list",        make_shared<BuiltinListAST>()},
-        {"else",        make_shared<BooleansTrueAST>()},
+        {"cons",          make_shared<BuiltinConsAST>()},
+        {"car",           make_shared<BuiltinCarAST>()},
+        {"cdr",           make_shared<BuiltinCdrAST>()},
+        {"+",             make_shared<BuiltinAddAST>()},
+        {"*",             make_shared<BuiltinMultiplyAST>()},
+        {"null?",         make_shared<BuiltinNullAST>()},
+        {"<",             make_shared<BuiltinLessThanAST>()},
+        {"#opposite",     make_shared<BuiltinOppositeAST>()},
+        {"#reciprocal",   make_shared<BuiltinReciprocalAST>()},
+        {"list",          make_shared<BuiltinListAST>()},
+        {"#mem-stats",    make_shared<BuiltinMemStatsAST>()},
+        {"#map",          make_shared<BuiltinMapAST>()},
+        {"#append",       make_shared<BuiltinAppendAST>()},
+        {"#reverse",      make_shared<BuiltinReverseAST>()},
+        {"#length",       make_shared<BuiltinLengthAST>()},
+        {"#reduce",       make_shared<BuiltinReduceAST>()},
+        {"#filter",       make_shared<BuiltinFilterAST>()},
+        {"#make-vector",  make_shared<BuiltinMakeVectorAST>()},
+        {"#vector",       make_shared<BuiltinVectorAST>()},
+        {"#vector-ref",   make_shared<BuiltinVectorRefAST>()},
+        {"#vector-set!",  make_shared<BuiltinVectorSetAST>()},
+        {"#vector-length", make_shared<BuiltinVectorLengthAST>()},
+        {"#vector-map",   make_shared<BuiltinVectorMapAST>()},
+        {"#vector->list", make_shared<BuiltinVectorToListAST>()},
+        {"#list->vector", make_shared<BuiltinListToVectorAST>()},
+        {"#equal?",       make_shared<BuiltinEqualAST>()},
+        {"#memoize",      make_shared<BuiltinMemoizeAST>()},
+        {"#memo-stats",   make_shared<BuiltinMemoStatsAST>()},
+        {"else",          make_shared<BooleansTrueAST>()},
     };
 
 }
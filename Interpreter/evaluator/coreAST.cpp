@@ -4,6 +4,11 @@
 #include <exception.h>
 #include <visitor.h>
 #include <context.h>
+#include <evalLimits.h>
+#include <framePool.h>
+#include <internTable.h>
+#include <profiler.h>
+#include <log.h>
 
 using namespace parser;
 using namespace exception;
@@ -12,47 +17,60 @@ using namespace visitor;
 
 void LambdaAST::setArgs(const std::vector<pExpr> &actualArgs, std::shared_ptr<Scope> &ss) const {
     for (size_t i = 0; i < actualArgs.size(); i++) {
-        if (formalArgs[i] != ".") {
-            ss->addSymbol(formalArgs[i], actualArgs[i]);
+        if (code->formalArgs[i] != ".") {
+            ss->addParam(code->formalArgs[i], actualArgs[i]);
+        } else if (code->restView) {
+            // One vector rather than a list of pairs
+            ss->addParam(code->formalArgs[i + 1], std::make_shared<RestArgsAST>(
+                std::make_shared<const std::vector<pExpr>>(actualArgs.begin() + i, actualArgs.end()), 0));
+            break;
         } else {
             // Attention: builtinList has to register itself
-            ss->stepIntoFunc("list");
-            ss->addSymbol(
-                formalArgs[i + 1],
+            static const std::string list = "list";
+            ss->stepIntoFunc(list);
+            ss->addParam(
+                code->formalArgs[i + 1],
                 std::make_shared<BuiltinListAST>()->apply(
                     std::vector<std::shared_ptr<ExprAST>>{actualArgs.begin() + i, actualArgs.end()},
                     ss));
             break;
         }
     }
-    if (actualArgs.size() == 1 && formalArgs.size() > 1 && formalArgs[1] == ".") {
-        ss->addSymbol(formalArgs[2], std::make_shared<NilAST>());
+    if (actualArgs.size() == 1 && code->formalArgs.size() > 1 && code->formalArgs[1] == ".") {
+        ss->addParam(code->formalArgs[2], std::make_shared<NilAST>());
     }
 }
 
 
 pExpr LambdaAST::apply(const std::vector<pExpr> &actualArgs, pScope &ss) const {
-    auto args = actualArgs;
+    // Arguments of current iteration of tail recursion
+    const std::vector<pExpr> *args = &actualArgs;
+    std::vector<pExpr> iterationArgs;
     pExpr ret = nullptr;
-    auto curScope = std::make_shared<Scope>();
+    const auto &expression = code->expression;
+    auto curScope = context::FramePool::scope();
     do {
-        // Create new scope
-        curScope->clearCurScope();
         curScope->setLexicalScope(context);
         // Like C with auto declaration: A invokes B while B appears behind A.
         curScope->setDynamicScope(ss);
-        setArgs(args, curScope);
+        setArgs(*args, curScope);
 
         for (int i = 0; i < expression.size() - 1; i++)
             // Don't eval sub-routine. It has been evaluated in LambdaAST::eval()
             // otherwise the temp scope will be stored in sub-routine, which consumes billions of bytes.
-            if (!std::dynamic_pointer_cast<LambdaBindingAST>(expression[i]))
+            if (!code->hasSubroutine || !nodeAs<LambdaBindingAST>(expression[i]))
                 expression[i]->eval(curScope);
 
         ret = expression.back()->eval(curScope);
 
-        if (auto ptr = std::dynamic_pointer_cast<TailRecursionArgs>(ret)) {
-            args = ptr->actualArgs;
+        if (auto ptr = nodeCast<TailRecursionArgs>(ret)) {
+            // Each iteration is a call in its own right
+            context::LimitGuard::step();
+            iterationArgs = std::move(ptr->actualArgs);
+            args = &iterationArgs;
+            // A closure made by last iteration may keep its scope, then the next one gets another
+            context::FramePool::recycle(curScope);
+            curScope = context::FramePool::scope();
         } else
             break;
 
@@ -60,16 +78,50 @@ pExpr LambdaAST::apply(const std::vector<pExpr> &actualArgs, pScope &ss) const {
 
     // remove current function name record
     ss->stepOutFunc();
+    context::FramePool::recycle(curScope);
     return ret;
 }
 
+bool LambdaAST::capture(const pScope &ss) const {
+    if (code->freeVariables.empty()) return true;
+    auto flat = context::FramePool::scope();
+    for (const auto &id : code->freeVariables) {
+        // Only a parameter keeps the value the closure would find when called: a definition may
+        // rebind a name later, e.g. top-level define of a function recursing into itself finds
+        // the name bound to the former definition. A variable found as a definition, by dynamic
+        // scope, or not at all yet is only known when called.
+        pExpr value;
+        bool param = false;
+        for (auto scope = ss.get(); scope && !value; scope = scope->lexicalScope.get()) {
+            value = scope->findLocal(id);
+            param = value && scope->findParam(id);
+        }
+        if (!param) {
+            context::FramePool::recycle(flat);
+            return false;
+        }
+        flat->addParam(id, std::move(value));
+    }
+    context = std::move(flat);
+    return true;
+}
+
 std::shared_ptr<ExprAST> LambdaAST::eval(std::shared_ptr<Scope> &ss) const {
     // Create new lambda and operate on it. AST itself should not be changed
-    auto lambda = std::make_shared<LambdaAST>(this->formalArgs, this->expression);
+    auto lambda = std::shared_ptr<LambdaAST>(new LambdaAST(code));
+
+    // A flat closure doesn't keep current scope, see visitor::CaptureVisitor
+    if (code->flat && lambda->capture(ss)) return lambda;
 
     // store current context;
-    // it has been done before sub-routine evaluation since eval add new node to context
-    lambda->context->setLexicalScope(ss);
+    // it has been done before sub-routine evaluation since eval add new node to context.
+    // Without sub-routines, current scope itself is the context.
+    if (!code->hasSubroutine) {
+        lambda->context = ss;
+    } else {
+        lambda->context = context::FramePool::scope();
+        lambda->context->setLexicalScope(ss);
+    }
 
     /*
      * Here we evaluate the sub-routine rather than lambda body.
@@ -84,36 +136,36 @@ std::shared_ptr<ExprAST> LambdaAST::eval(std::shared_ptr<Scope> &ss) const {
      *    /
      *  (b)
      */
-    for (auto expr: expression)
-        if (std::shared_ptr<LambdaBindingAST> ptr = std::dynamic_pointer_cast<LambdaBindingAST>(expr)) {
+    for (auto expr: code->expression)
+        if (auto ptr = nodeAs<LambdaBindingAST>(expr)) {
             // Add sub-routine into original context of this lambda
             ptr->eval(lambda->context);
         }
 
     // Just derive child node. Hence lambda's context won't be modified afterwards.
     auto parent = ss;
-    ss = std::make_shared<Scope>();
+    ss = context::FramePool::scope();
     ss->setLexicalScope(parent);
 
     return lambda;
 }
 
 std::shared_ptr<ExprAST> LambdaBindingAST::eval(std::shared_ptr<Scope> &ss) const {
-    CLOG(DEBUG, "evaluator") << "eval [" << getIdentifier() << "]";
+    DEBUG_LOG("evaluator") << "eval [" << getIdentifier() << "]";
     ss->addSymbol(getIdentifier(), lambda->eval(ss));
-    CLOG(DEBUG, "evaluator") << "eval [" << getIdentifier() << "] done";
+    DEBUG_LOG("evaluator") << "eval [" << getIdentifier() << "] done";
     return getPointer();
 }
 
 std::vector<pExpr> IfStatementAST::getTailRecursionArgs(
     const std::shared_ptr<ExprAST> &clause, std::shared_ptr<Scope> &ss) const {
-    if (auto callable = std::dynamic_pointer_cast<InvocationAST>(clause)) {
-        if (auto id = std::dynamic_pointer_cast<IdentifierAST>(callable->callableObj)) {
+    if (auto callable = nodeAs<InvocationAST>(clause)) {
+        if (auto id = nodeAs<IdentifierAST>(callable->callableObj)) {
             if (id->getId() == ss->currentFunc()) {
-                CLOG(DEBUG, "evaluator") << "tail recursion detected " << ss->currentFunc();
+                DEBUG_LOG("evaluator") << "tail recursion detected " << ss->currentFunc();
                 std::vector<pExpr> evalRes;
                 for (const auto &ptr: callable->actualArgs) evalRes.push_back(ptr->eval(ss));
-                CLOG(DEBUG, "evaluator") << "tail recursion arguments done " << ss->currentFunc();
+                DEBUG_LOG("evaluator") << "tail recursion arguments done " << ss->currentFunc();
                 return std::move(evalRes);
             }
         }
@@ -123,7 +175,7 @@ std::vector<pExpr> IfStatementAST::getTailRecursionArgs(
 
 std::shared_ptr<ExprAST> IfStatementAST::eval(std::shared_ptr<Scope> &ss) const {
     auto ptr = condition->eval(ss);
-    if (auto boolFalsePtr = std::dynamic_pointer_cast<BooleansFalseAST>(ptr)) {
+    if (nodeAs<BooleansFalseAST>(ptr)) {
         return eval(falseClause, ss);
     } else {
         return eval(trueClause, ss);
@@ -134,33 +186,91 @@ std::shared_ptr<ExprAST> IfStatementAST::eval(
     const std::shared_ptr<ExprAST> &branch, std::shared_ptr<Scope> &ss) const {
     auto args = getTailRecursionArgs(branch, ss);
     if (!args.empty()) {
-        return std::make_shared<TailRecursionArgs>(args);
+        return std::make_shared<TailRecursionArgs>(std::move(args));
     } else {
         return branch->eval(ss);
     }
 }
 
 std::shared_ptr<ExprAST> InvocationAST::eval(std::shared_ptr<Scope> &ss) const {
+    context::LimitGuard::step();
     // Eval the arguments each time: it depends on scope
-    std::vector<pExpr> evalRes;
+    context::FramePool::Args frame;
+    auto &evalRes = frame.values;
     for (const auto &ptr: actualArgs) evalRes.push_back(ptr->eval(ss));
 
     std::shared_ptr<ExprAST> ret;
 
-    if (std::dynamic_pointer_cast<LambdaAST>(callableObj)) {
-        ss->stepIntoAnonymousFunc();
+    if (auto lambda = nodeAs<LambdaAST>(callableObj)) {
+        ss->stepIntoAnonymousFunc(lambda->getLocation());
         ret = callableObj->apply(evalRes, ss);
 
-    } else if (auto id = std::dynamic_pointer_cast<IdentifierAST>(callableObj)) {
-        auto lambda = id->eval(ss);
+    } else if (auto id = nodeAs<IdentifierAST>(callableObj)) {
+        auto lambda = builtin ? builtin : cache.lookup(id->getId(), ss);
+        if (!lambda) throw UnboundIdentifier("Unbound identifier: " + id->getId());
         ss->stepIntoFunc(id->getId());
         ret = lambda->apply(evalRes, ss);
     } else {
         // it may be a function call which returns lambda, so just eval it first
         auto lambda = callableObj->eval(ss);
-        ss->stepIntoAnonymousFunc();
+        auto defined = nodeAs<LambdaAST>(lambda);
+        ss->stepIntoAnonymousFunc(defined ? defined->getLocation() : "");
         ret = lambda->apply(evalRes, ss);
     }
     return ret;
 }
 
+InlineBuiltinAST::InlineBuiltinAST(Op op, const std::shared_ptr<ExprAST> &lam,
+                                   const std::vector<std::shared_ptr<ExprAST>> &args)
+    : InvocationAST(lam, args), op{op} {}
+
+bool InlineBuiltinAST::inlinable(const std::string &name, std::size_t argc, Op &op) {
+    static const std::map<std::string, std::pair<Op, std::size_t>> ops = {
+        {"car",  {Op::CAR,      1}},
+        {"cdr",  {Op::CDR,      1}},
+        {"cons", {Op::CONS,     2}},
+        {"+",    {Op::ADD,      2}},
+        {"*",    {Op::MULTIPLY, 2}},
+    };
+    auto it = ops.find(name);
+    if (it == ops.end() || it->second.second != argc) return false;
+    op = it->second.first;
+    return true;
+}
+
+pExpr InlineBuiltinAST::getPointer() const {
+    return std::make_shared<InlineBuiltinAST>(*this);
+}
+
+std::shared_ptr<ExprAST> InlineBuiltinAST::eval(std::shared_ptr<Scope> &ss) const {
+    // Profile shows builtins as calls
+    if (profiler::Profiler::enabled) return InvocationAST::eval(ss);
+    context::LimitGuard::step();
+    auto first = actualArgs[0]->eval(ss);
+    if (op == Op::CAR || op == Op::CDR) {
+        if (auto pair = nodeAs<PairAST>(first))
+            return op == Op::CAR ? pair->data.first : pair->data.second;
+        return callBuiltin(first, nullptr, ss);
+    }
+
+    auto second = actualArgs[1]->eval(ss);
+    if (op == Op::CONS) {
+        // BuiltinConsAST evaluates its arguments once more
+        auto car = first->eval(ss);
+        return context::InternTable::pair(car, second->eval(ss));
+    }
+    auto x = nodeAs<NumberAST>(first);
+    auto y = nodeAs<NumberAST>(second);
+    if (!x || !y) return callBuiltin(first, second, ss);
+    return context::InternTable::number(op == Op::ADD ? x->getValue() + y->getValue()
+                                                      : x->getValue() * y->getValue());
+}
+
+pExpr InlineBuiltinAST::callBuiltin(const pExpr &first, const pExpr &second, pScope &ss) const {
+    context::FramePool::Args frame;
+    frame.values.push_back(first);
+    if (second) frame.values.push_back(second);
+    ss->stepIntoFunc(std::static_pointer_cast<IdentifierAST>(callableObj)->getId());
+    return builtin->apply(frame.values, ss);
+}
+
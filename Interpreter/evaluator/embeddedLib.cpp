@@ -0,0 +1,16 @@
+#include <embeddedLib.h>
+#include <exception.h>
+
+using namespace exception;
+
+bool embedded::contains(const std::string &name) {
+    for (const auto &lib: libraries())
+        if (lib.first == name) return true;
+    return false;
+}
+
+const std::string &embedded::source(const std::string &name) {
+    for (const auto &lib: libraries())
+        if (lib.first == name) return lib.second;
+    throw RuntimeError("No embedded library: " + name);
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <escape.h>
+#include <context.h>
+
+using namespace visitor;
+using namespace ast;
+using namespace std;
+
+bool EscapeVisitor::restEscapes(const LambdaAST &lambda) {
+    EscapeVisitor visitor;
+    auto dot = find(begin(lambda.code->formalArgs), end(lambda.code->formalArgs), ".");
+    visitor.var = *(dot + 1);
+    lambda.accept(visitor);
+    visitor.counting = false;
+
+    map<string, const LambdaAST *> inner;
+    for (const auto &expr : lambda.code->expression)
+        if (auto binding = nodeAs<LambdaBindingAST>(expr))
+            inner[binding->getIdentifier()] = binding->lambda.get();
+
+    // Follow the variable into inner functions, one parameter at a time
+    set<pair<string, size_t>> done;
+    while (!visitor.escaped) {
+        auto next = find_if(begin(visitor.passed), end(visitor.passed),
+                            [&](const pair<string, size_t> &call) { return !done.count(call); });
+        if (next == end(visitor.passed)) break;
+        auto call = *next;
+        done.insert(call);
+
+        // Builtins are found before anything else, and a name bound twice may not be the inner function
+        auto fn = inner.find(call.first);
+        if (fn == end(inner) || visitor.bindings[call.first] != 1 || context::Scope::builtinFunc.count(call.first))
+            return true;
+        const auto &formalArgs = fn->second->code->formalArgs;
+        auto k = call.second;
+        // The parameter must not be a rest one
+        if (k >= formalArgs.size() || find(begin(formalArgs), begin(formalArgs) + k + 1, ".") <= begin(formalArgs) + k)
+            return true;
+        visitor.var = formalArgs[k];
+        fn->second->accept(visitor);
+    }
+    return visitor.escaped;
+}
+
+bool EscapeVisitor::isView(const pExpr &expr) const {
+    if (auto id = nodeAs<IdentifierAST>(expr))
+        return id->getId() == var;
+    if (auto invocation = nodeAs<InvocationAST>(expr)) {
+        auto id = nodeAs<IdentifierAST>(invocation->callableObj);
+        return id && id->getId() == "cdr" && invocation->actualArgs.size() == 1 && isView(invocation->actualArgs[0]);
+    }
+    return false;
+}
+
+void EscapeVisitor::bind(const string &name) {
+    if (counting) bindings[name]++;
+}
+
+void EscapeVisitor::visitIdentifierAST(const IdentifierAST &id) {
+    if (id.getId() == var) escaped = true;
+}
+
+void EscapeVisitor::visitIfStatementAST(const IfStatementAST &ifStatement) {
+    ifStatement.condition->accept(*this);
+    ifStatement.trueClause->accept(*this);
+    ifStatement.falseClause->accept(*this);
+}
+
+void EscapeVisitor::visitCondStatementAST(const CondStatementAST &cond) {
+    cond.ifStatement->accept(*this);
+}
+
+void EscapeVisitor::visitLetStatementAST(const LetStatementAST &let) {
+    for (const auto &id : let.identifier)
+        if (auto ptr = nodeAs<IdentifierAST>(id)) bind(ptr->getId());
+    for (const auto &value : let.value) value->accept(*this);
+    let.expr->accept(*this);
+}
+
+void EscapeVisitor::visitLoadingFileAST(const LoadingFileAST &) {
+    // Anything may be defined by the file
+    escaped = true;
+}
+
+void EscapeVisitor::visitPairAST(const PairAST &pair) {
+    pair.data.first->accept(*this);
+    pair.data.second->accept(*this);
+}
+
+void EscapeVisitor::visitValueBindingAST(const ValueBindingAST &binding) {
+    bind(binding.getIdentifier());
+    binding.value->accept(*this);
+}
+
+void EscapeVisitor::visitLambdaAST(const LambdaAST &lambda) {
+    for (const auto &arg : lambda.code->formalArgs)
+        if (arg != ".") bind(arg);
+    for (const auto &expr : lambda.code->expression) expr->accept(*this);
+}
+
+void EscapeVisitor::visitLambdaBindingAST(const LambdaBindingAST &binding) {
+    bind(binding.getIdentifier());
+    binding.lambda->accept(*this);
+}
+
+void EscapeVisitor::visitLambdaApplicationAST(const InvocationAST &invocation) {
+    auto id = nodeAs<IdentifierAST>(invocation.callableObj);
+    auto unary = invocation.actualArgs.size() == 1;
+    if (id && id->getId() == "cdr" && unary && isView(invocation.actualArgs[0])) {
+        // A view itself, where views are not expected
+        escaped = true;
+        return;
+    }
+    invocation.callableObj->accept(*this);
+    for (size_t k = 0; k < invocation.actualArgs.size(); k++) {
+        const auto &arg = invocation.actualArgs[k];
+        if (!isView(arg))
+            arg->accept(*this);
+        else if (id && unary && (id->getId() == "car" || id->getId() == "null?"))
+            continue;
+        else if (id)
+            passed.insert({id->getId(), k});
+        else
+            escaped = true;
+    }
+}
+
+bool CaptureVisitor::freeVariables(const LambdaAST &lambda, vector<string> &vars) {
+    CaptureVisitor visitor{vars};
+    for (const auto &arg : lambda.code->formalArgs)
+        if (arg != ".") visitor.params.insert(arg);
+    for (const auto &expr : lambda.code->expression) expr->accept(visitor);
+    if (!visitor.flat) vars.clear();
+    return visitor.flat;
+}
+
+void CaptureVisitor::visitIdentifierAST(const IdentifierAST &id) {
+    const auto &name = id.getId();
+    if (params.count(name) || context::Scope::builtinFunc.count(name)) return;
+    if (find(begin(vars), end(vars), name) == end(vars)) vars.push_back(name);
+}
+
+void CaptureVisitor::visitIfStatementAST(const IfStatementAST &ifStatement) {
+    ifStatement.condition->accept(*this);
+    ifStatement.trueClause->accept(*this);
+    ifStatement.falseClause->accept(*this);
+}
+
+void CaptureVisitor::visitCondStatementAST(const CondStatementAST &cond) {
+    cond.ifStatement->accept(*this);
+}
+
+void CaptureVisitor::visitLetStatementAST(const LetStatementAST &) {
+    flat = false;
+}
+
+void CaptureVisitor::visitLoadingFileAST(const LoadingFileAST &) {
+    flat = false;
+}
+
+void CaptureVisitor::visitPairAST(const PairAST &pair) {
+    pair.data.first->accept(*this);
+    pair.data.second->accept(*this);
+}
+
+void CaptureVisitor::visitValueBindingAST(const ValueBindingAST &) {
+    flat = false;
+}
+
+void CaptureVisitor::visitLambdaAST(const LambdaAST &) {
+    flat = false;
+}
+
+void CaptureVisitor::visitLambdaBindingAST(const LambdaBindingAST &) {
+    flat = false;
+}
+
+void CaptureVisitor::visitLambdaApplicationAST(const InvocationAST &invocation) {
+    invocation.callableObj->accept(*this);
+    for (const auto &arg : invocation.actualArgs) arg->accept(*this);
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <climits>
+#include <context.h>
+#include <evalLimits.h>
+#include <exception.h>
+#include <profiler.h>
+
+using namespace context;
+using namespace std;
+using namespace std::chrono;
+
+thread_local long LimitGuard::countdown = LONG_MAX;
+thread_local LimitGuard *LimitGuard::current = nullptr;
+
+namespace {
+    // Steps until next check; a limited guard checks right after its last allowed step
+    long nextBatch(const Limits &limits, unsigned long steps) {
+        if (!limits.steps) return LimitGuard::CHECK_INTERVAL;
+        auto remaining = limits.steps + 1 - steps;
+        return remaining < (unsigned long) LimitGuard::CHECK_INTERVAL ? (long) remaining : LimitGuard::CHECK_INTERVAL;
+    }
+}
+
+LimitGuard::LimitGuard(const Limits &limits) : limits(limits), previous(current),
+                                                 traceDepth(Scope::callTrace.size()),
+                                                 counting(limits.heap != 0),
+                                                 heapBase(profiler::heapBalance()),
+                                                 deadline(steady_clock::now() + limits.time) {
+    // Steps of a nested guard are not charged to the outer one
+    if (previous) {
+        previous->steps += previous->batch - countdown;
+        previous->batch = 0;
+    }
+    current = this;
+    countdown = batch = nextBatch(limits, 0);
+}
+
+LimitGuard::~LimitGuard() {
+    while (Scope::callTrace.size() > traceDepth) {
+        Scope::callTrace.pop();
+        if (profiler::Profiler::enabled) profiler::Profiler::leave();
+    }
+    current = previous;
+    if (previous) countdown = previous->batch = nextBatch(previous->limits, previous->steps);
+    else countdown = LONG_MAX;
+}
+
+void LimitGuard::reserve(std::size_t n) {
+    auto guard = current;
+    if (!guard || !guard->limits.heap) return;
+    auto used = profiler::heapBalance() - guard->heapBase;
+    if (n > guard->limits.heap || used > (long long) (guard->limits.heap - n))
+        throw exception::LimitExceeded("heap limit exceeded: " + to_string(guard->limits.heap) + " bytes");
+}
+
+void LimitGuard::check() {
+    auto guard = current;
+    if (!guard) {
+        countdown = LONG_MAX;
+        return;
+    }
+    guard->steps += guard->batch - countdown;
+    // Until it's reset below, every step checks again, so a caught exception is thrown again on next step
+    guard->batch = countdown = 0;
+
+    auto &limits = guard->limits;
+    if (limits.cancel.cancelled())
+        throw exception::Cancelled("evaluation cancelled");
+    if (limits.steps && guard->steps > limits.steps)
+        throw exception::LimitExceeded("step limit exceeded: " + to_string(limits.steps) + " steps");
+    if (limits.depth && Scope::callTrace.size() - guard->traceDepth > limits.depth)
+        throw exception::LimitExceeded("depth limit exceeded: " + to_string(limits.depth) + " nested calls");
+    if (limits.heap && profiler::heapBalance() - guard->heapBase > (long long) limits.heap)
+        throw exception::LimitExceeded("heap limit exceeded: " + to_string(limits.heap) + " bytes");
+    if (limits.time.count() && steady_clock::now() > guard->deadline)
+        throw exception::LimitExceeded("time limit exceeded: " + to_string(limits.time.count()) + " ms");
+
+    countdown = guard->batch = nextBatch(limits, guard->steps);
+}
@@ -0,0 +1,44 @@
+#include <framePool.h>
+
+namespace context {
+    namespace {
+        thread_local std::vector<pScope> scopes;
+        thread_local std::vector<std::vector<pExpr>> argVectors;
+    }
+
+    pScope FramePool::scope() {
+        if (scopes.empty()) return std::make_shared<Scope>();
+        auto s = std::move(scopes.back());
+        scopes.pop_back();
+        return s;
+    }
+
+    void FramePool::recycle(pScope &s) {
+        // Once a scope is dropped, its lexical parent may be referred by nothing else either,
+        // e.g. scope of a call whose closures are all gone
+        while (s && s.use_count() == 1) {
+            auto parent = std::move(s->lexicalScope);
+            if (scopes.size() < CAPACITY) {
+                s->clearCurScope();
+                s->dynamicScope = nullptr;
+                scopes.push_back(std::move(s));
+            }
+            s = std::move(parent);
+        }
+        s = nullptr;
+    }
+
+    FramePool::Args::Args() {
+        if (!argVectors.empty()) {
+            values = std::move(argVectors.back());
+            argVectors.pop_back();
+        }
+    }
+
+    FramePool::Args::~Args() {
+        if (argVectors.size() < CAPACITY) {
+            values.clear();
+            argVectors.push_back(std::move(values));
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <inlineCache.h>
+
+namespace context {
+    namespace {
+        struct Entry {
+            std::uint64_t generation = 0;
+            const Scope *parent = nullptr;
+            std::uint64_t serial = 0;
+            std::uint64_t version = 0;
+            // Weak: entries of a site on other threads outlive the site until their index is reused
+            std::weak_ptr<ast::ExprAST> callee;
+        };
+
+        // Set once entries of this thread are destroyed; a site destroyed later, e.g. one held by
+        // a static object, has nothing to release
+        thread_local bool entriesGone = false;
+
+        struct Entries : std::vector<Entry> {
+            ~Entries() { entriesGone = true; }
+        };
+
+        thread_local Entries entries;
+
+        // Bumped by each definition
+        std::atomic<std::uint64_t> version{0};
+
+        // Stamps are taken in blocks, so threads rarely touch the shared counter
+        const std::uint64_t STAMP_BLOCK = 1 << 16;
+        std::atomic<std::uint64_t> nextStamp{1};
+
+        std::mutex sitesMutex;
+        std::vector<std::size_t> freeSites;
+        std::size_t siteCount = 0;
+
+        std::size_t newSite() {
+            std::lock_guard<std::mutex> lock{sitesMutex};
+            if (freeSites.empty()) return siteCount++;
+            auto site = freeSites.back();
+            freeSites.pop_back();
+            return site;
+        }
+    }
+
+    InlineCache::InlineCache() : site{newSite()}, generation{stamp()} {}
+
+    InlineCache::InlineCache(const InlineCache &) : InlineCache() {}
+
+    InlineCache::~InlineCache() {
+        if (!entriesGone && site < entries.size()) entries[site] = Entry{};
+        std::lock_guard<std::mutex> lock{sitesMutex};
+        freeSites.push_back(site);
+    }
+
+    pExpr InlineCache::lookup(const std::string &id, const pScope &ss) const {
+        // Parameters and definitions of the current call differ from call to call
+        auto ret = ss->findLocal(id);
+        if (ret) return ret;
+
+        const auto &parent = ss->lexicalScope;
+        if (parent) {
+            if (site >= entries.size()) entries.resize(site + 1);
+            auto &entry = entries[site];
+            auto current = version.load(std::memory_order_acquire);
+            if (entry.generation == generation && entry.parent == parent.get() && entry.serial == parent->serial
+                && entry.version == current)
+                if ((ret = entry.callee.lock()) != nullptr) return ret;
+            if ((ret = parent->findSymbol(id)) != nullptr) {
+                entry.generation = generation;
+                entry.parent = parent.get();
+                entry.serial = parent->serial;
+                entry.version = current;
+                entry.callee = ret;
+                return ret;
+            }
+        }
+        if (ss->dynamicScope) ret = ss->dynamicScope->findSymbol(id);
+        return ret;
+    }
+
+    void InlineCache::invalidate() {
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    std::uint64_t InlineCache::stamp() {
+        thread_local std::uint64_t next = 0, end = 0;
+        if (next == end) {
+            next = nextStamp.fetch_add(STAMP_BLOCK, std::memory_order_relaxed);
+            end = next + STAMP_BLOCK;
+        }
+        return next++;
+    }
+}
@@ -0,0 +1,184 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <AST.h>
+#include <internTable.h>
+
+using namespace ast;
+
+namespace context {
+    bool InternTable::enabled = false;
+
+    namespace {
+        using PairKey = std::pair<std::uintptr_t, std::uintptr_t>;
+
+        struct PairKeyHash {
+            std::size_t operator()(const PairKey &k) const {
+                auto h = std::hash<std::uintptr_t>()(k.first);
+                return h ^ (std::hash<std::uintptr_t>()(k.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+            }
+        };
+
+        // The object is kept along with the weak reference, so that a value being destroyed removes
+        // its own entry only, not one made for the same key meanwhile
+        template<class T>
+        struct Entry {
+            const T *object;
+            std::weak_ptr<ExprAST> value;
+        };
+
+        // Values are spread over shards by key, each with a lock of its own, so that parallel
+        // renders rarely wait for each other
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<std::uint64_t, Entry<NumberAST>> numbers;
+            std::unordered_map<PairKey, Entry<PairAST>, PairKeyHash> pairs;
+        };
+
+        // 2^6, see shard
+        const std::size_t SHARDS = 64;
+
+        // Never destroyed: values held by static objects may outlive any static table
+        Shard *table() {
+            static auto t = new Shard[SHARDS];
+            return t;
+        }
+
+        // Low bits of keys are alike, e.g. those of small integers, or of aligned addresses,
+        // so the shard is picked by the high bits of a mixed hash
+        Shard &shard(std::uint64_t hash) {
+            return table()[(hash * 0x9e3779b97f4a7c15ULL) >> 58];
+        }
+
+        std::uint64_t numberKey(double n) {
+            std::uint64_t k;
+            std::memcpy(&k, &n, sizeof k);
+            return k;
+        }
+
+        // Identifies what a pair refers to, if it can be shared. Nil and booleans have no identity,
+        // so they are told by kind; those values aren't valid addresses.
+        bool childKey(const pExpr &v, std::uintptr_t &key) {
+            if (v->isCanonical()) {
+                key = reinterpret_cast<std::uintptr_t>(v.get());
+                return true;
+            }
+            switch (v->kind()) {
+                case NodeKind::NIL:
+                case NodeKind::TRUE:
+                case NodeKind::FALSE:
+                    key = static_cast<std::uintptr_t>(v->kind());
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // Remove entry of object at key unless it's been replaced
+        template<class Map, class Key, class T>
+        void release(Shard &shard, Map &map, const Key &key, const T *object) {
+            std::lock_guard<std::mutex> lock{shard.mutex};
+            auto it = map.find(key);
+            if (it != map.end() && it->second.object == object) map.erase(it);
+        }
+    }
+
+    pExpr InternTable::number(double n) {
+        if (!enabled || std::isnan(n) || (n == 0 && std::signbit(n))) return std::make_shared<NumberAST>(n);
+
+        auto key = numberKey(n);
+        auto &t = shard(key);
+        std::lock_guard<std::mutex> lock{t.mutex};
+        auto &entry = t.numbers[key];
+        if (auto ret = entry.value.lock()) return ret;
+        // Released outside of the lock by the deleter
+        auto object = new NumberAST(n);
+        object->canonical = true;
+        pExpr ret{object, [&t, key](NumberAST *p) {
+            release(t, t.numbers, key, p);
+            delete p;
+        }};
+        entry = Entry<NumberAST>{object, ret};
+        return ret;
+    }
+
+    pExpr InternTable::pair(const pExpr &car, const pExpr &cdr) {
+        PairKey key;
+        if (!enabled || !childKey(car, key.first) || !childKey(cdr, key.second))
+            return std::make_shared<PairAST>(car, cdr);
+
+        auto &t = shard(PairKeyHash()(key));
+        std::lock_guard<std::mutex> lock{t.mutex};
+        auto &entry = t.pairs[key];
+        if (auto ret = entry.value.lock()) return ret;
+        auto object = new PairAST(car, cdr);
+        object->canonical = true;
+        pExpr ret{object, [&t, key](PairAST *p) {
+            release(t, t.pairs, key, p);
+            // Releasing car and cdr may release their entries, so it's done after the lock is given back
+            delete p;
+        }};
+        entry = Entry<PairAST>{object, ret};
+        return ret;
+    }
+
+    namespace {
+        // Pairs of vector elements met so far by one comparison
+        using Compared = std::set<std::pair<const void *, const void *>>;
+
+        bool sameStructure(const ExprAST *a, const ExprAST *b, Compared &compared) {
+            // Lists are walked along cdr, so only nesting by car takes stack
+            for (;;) {
+                if (a == b) return true;
+                if (a->kind() != b->kind() || (a->isCanonical() && b->isCanonical())) return false;
+                switch (a->kind()) {
+                    case NodeKind::NUMBER:
+                        return nodeAs<NumberAST>(a)->getValue() == nodeAs<NumberAST>(b)->getValue();
+                    case NodeKind::TRUE:
+                    case NodeKind::FALSE:
+                    case NodeKind::NIL:
+                        return true;
+                    case NodeKind::VECTOR: {
+                        auto &x = *nodeAs<VectorAST>(a)->elements, &y = *nodeAs<VectorAST>(b)->elements;
+                        if (&x == &y) return true;
+                        if (x.size() != y.size()) return false;
+                        // vector-set! may make vectors contain themselves. A pair met again is taken as
+                        // equal: if it isn't, a difference is found where it was met first.
+                        if (!compared.emplace(&x, &y).second) return true;
+                        for (std::size_t i = 0; i < x.size(); i++)
+                            if (!sameStructure(x[i].get(), y[i].get(), compared)) return false;
+                        return true;
+                    }
+                    case NodeKind::PAIR: {
+                        auto p = nodeAs<PairAST>(a), q = nodeAs<PairAST>(b);
+                        if (!sameStructure(p->data.first.get(), q->data.first.get(), compared)) return false;
+                        a = p->data.second.get();
+                        b = q->data.second.get();
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+        }
+    }
+
+    bool InternTable::equal(const ExprAST *a, const ExprAST *b) {
+        Compared compared;
+        return sameStructure(a, b, compared);
+    }
+
+    std::size_t InternTable::size() {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < SHARDS; i++) {
+            auto &t = table()[i];
+            std::lock_guard<std::mutex> lock{t.mutex};
+            n += t.numbers.size() + t.pairs.size();
+        }
+        return n;
+    }
+}
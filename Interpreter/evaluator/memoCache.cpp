@@ -0,0 +1,113 @@
+#include <functional>
+#include <iterator>
+#include <AST.h>
+#include <internTable.h>
+#include <memoCache.h>
+
+using namespace ast;
+
+namespace context {
+    namespace {
+        void combine(std::size_t &hash, std::size_t x) {
+            hash ^= x + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+
+        // Hash of a number, boolean, nil or list of them; false for any other value
+        bool hashValue(const ExprAST *v, std::size_t &hash) {
+            // Lists are walked along cdr, so only nesting by car takes stack
+            for (;; v = nodeAs<PairAST>(v)->data.second.get()) {
+                combine(hash, static_cast<std::size_t>(v->kind()));
+                switch (v->kind()) {
+                    case NodeKind::NUMBER: {
+                        auto n = nodeAs<NumberAST>(v)->getValue();
+                        // 0 and -0 are equal
+                        combine(hash, std::hash<double>()(n == 0 ? 0.0 : n));
+                        return true;
+                    }
+                    case NodeKind::TRUE:
+                    case NodeKind::FALSE:
+                    case NodeKind::NIL:
+                        return true;
+                    case NodeKind::PAIR:
+                        if (!hashValue(nodeAs<PairAST>(v)->data.first.get(), hash)) return false;
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+        bool sameArgs(const std::vector<pExpr> &a, const std::vector<pExpr> &b) {
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); i++)
+                if (!InternTable::equal(a[i].get(), b[i].get())) return false;
+            return true;
+        }
+    }
+
+    bool MemoCache::key(const std::vector<pExpr> &args, std::size_t &hash) {
+        hash = args.size();
+        for (const auto &arg : args)
+            if (!hashValue(arg.get(), hash)) return false;
+        return true;
+    }
+
+    pExpr MemoCache::find(const std::vector<pExpr> &args, std::size_t hash) {
+        std::lock_guard<std::mutex> lock{mutex};
+        auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (sameArgs(it->second->args, args)) {
+                entries.splice(entries.begin(), entries, it->second);
+                hitCount++;
+                return it->second->result;
+            }
+        }
+        missCount++;
+        return nullptr;
+    }
+
+    void MemoCache::insert(const std::vector<pExpr> &args, std::size_t hash, const pExpr &result) {
+        std::size_t ignored = 0;
+        if (capacity == 0 || !hashValue(result.get(), ignored)) return;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        // Another thread may have made the same call meanwhile
+        auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if (sameArgs(it->second->args, args)) return;
+
+        if (entries.size() == capacity) {
+            auto &last = entries.back();
+            auto lastRange = index.equal_range(last.hash);
+            for (auto it = lastRange.first; it != lastRange.second; ++it) {
+                if (it->second == std::prev(entries.end())) {
+                    index.erase(it);
+                    break;
+                }
+            }
+            entries.pop_back();
+        }
+        entries.push_front(Entry{hash, args, result});
+        index.emplace(hash, entries.begin());
+    }
+
+    void MemoCache::uncached() {
+        std::lock_guard<std::mutex> lock{mutex};
+        missCount++;
+    }
+
+    std::size_t MemoCache::hits() const {
+        std::lock_guard<std::mutex> lock{mutex};
+        return hitCount;
+    }
+
+    std::size_t MemoCache::misses() const {
+        std::lock_guard<std::mutex> lock{mutex};
+        return missCount;
+    }
+
+    std::size_t MemoCache::size() const {
+        std::lock_guard<std::mutex> lock{mutex};
+        return entries.size();
+    }
+}
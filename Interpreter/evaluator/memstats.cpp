@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <cxxabi.h>
+#include <memstats.h>
+
+using namespace profiler;
+using namespace std;
+
+namespace {
+    // Registered during static initialization, so no lock is needed
+    vector<unique_ptr<MemoryStats::Entry>> &entries() {
+        static vector<unique_ptr<MemoryStats::Entry>> registry;
+        return registry;
+    }
+
+    atomic<long> totalLive{0}, totalPeak{0};
+
+    void raise(atomic<long> &peak, long value) {
+        auto cur = peak.load(memory_order_relaxed);
+        while (value > cur && !peak.compare_exchange_weak(cur, value, memory_order_relaxed));
+    }
+
+    // "ast::PairAST" => "PairAST"
+    string typeName(const type_info &type) {
+        int status;
+        auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        string name = status == 0 ? demangled : type.name();
+        free(demangled);
+        auto pos = name.rfind("::");
+        return pos == string::npos ? name : name.substr(pos + 2);
+    }
+}
+
+bool MemoryStats::enabled = false;
+
+void MemoryStats::Entry::add() {
+    created.fetch_add(1, memory_order_relaxed);
+    raise(peak, live.fetch_add(1, memory_order_relaxed) + 1);
+    raise(totalPeak, totalLive.fetch_add(1, memory_order_relaxed) + 1);
+}
+
+void MemoryStats::Entry::remove() {
+    live.fetch_sub(1, memory_order_relaxed);
+    totalLive.fetch_sub(1, memory_order_relaxed);
+}
+
+MemoryStats::Entry *MemoryStats::registerType(const std::type_info &type) {
+    entries().emplace_back(new Entry);
+    entries().back()->name = typeName(type);
+    return entries().back().get();
+}
+
+long MemoryStats::live() {
+    return totalLive.load(memory_order_relaxed);
+}
+
+long MemoryStats::peak() {
+    return totalPeak.load(memory_order_relaxed);
+}
+
+void MemoryStats::report(std::ostream &os) {
+    vector<const Entry *> sorted;
+    for (const auto &entry : entries()) sorted.push_back(entry.get());
+    sort(sorted.begin(), sorted.end(), [](const Entry *a, const Entry *b) {
+        return a->created > b->created;
+    });
+    os << setw(12) << "created" << setw(12) << "live" << setw(12) << "peak live" << "  type\n";
+    for (auto entry : sorted) {
+        if (entry->created == 0 && entry->live == 0) continue;
+        os << setw(12) << entry->created << setw(12) << entry->live << setw(12) << entry->peak
+           << "  " << entry->name << "\n";
+    }
+    os << setw(12) << "" << setw(12) << live() << setw(12) << peak() << "  (total)\n";
+}
+
+void MemoryStats::reset() {
+    for (auto &entry : entries()) {
+        entry->created = 0;
+        entry->peak = entry->live.load();
+    }
+    totalPeak = totalLive.load();
+}
@@ -0,0 +1,153 @@
+#include <set>
+#include <algorithm>
+#include <optimizer.h>
+#include <context.h>
+#include <exception.h>
+#include <arena.h>
+#include <tracer.h>
+
+using namespace visitor;
+using namespace ast;
+using namespace parser;
+using namespace exception;
+using namespace std;
+
+namespace {
+    // Builtins without side effect
+    const set<string> pureBuiltin = {
+        "cons", "car", "cdr", "+", "*", "null?", "<", "#opposite", "#reciprocal", "list",
+    };
+
+    bool isLiteral(const pExpr &expr) {
+        if (nodeAs<NumberAST>(expr) || nodeAs<BooleansTrueAST>(expr)
+            || nodeAs<BooleansFalseAST>(expr) || nodeAs<NilAST>(expr))
+            return true;
+        if (auto pair = nodeAs<PairAST>(expr))
+            return isLiteral(pair->data.first) && isLiteral(pair->data.second);
+        return false;
+    }
+
+    // Like IfStatementAST::getTailRecursionArgs: a call in if branch may be a tail recursion
+    bool isCall(const pExpr &expr) {
+        return nodeAs<InvocationAST>(expr) != nullptr;
+    }
+}
+
+bool OptimizeVisitor::enabled = true;
+
+pExpr OptimizeVisitor::optimize(const pExpr &expr) {
+    // Nodes without children stay as they are
+    result = expr;
+    expr->accept(*this);
+    return result;
+}
+
+bool OptimizeVisitor::optimizeAll(const vector<pExpr> &exprs, vector<pExpr> &res) {
+    bool changed = false;
+    for (const auto &expr: exprs) {
+        res.push_back(optimize(expr));
+        changed |= res.back() != expr;
+    }
+    return changed;
+}
+
+void OptimizeVisitor::visitAllExprAST(const AllExprAST &all) {
+    auto self = result;
+    vector<pExpr> exprs;
+    result = optimizeAll(all.exprVec, exprs) ? make_shared<AllExprAST>(exprs) : self;
+}
+
+void OptimizeVisitor::visitIdentifierAST(const IdentifierAST &id) {
+    // `else` is a builtin constant
+    if (id.getId() == "else") result = makeNode<BooleansTrueAST>();
+}
+
+void OptimizeVisitor::visitIfStatementAST(const IfStatementAST &ifStatement) {
+    auto self = result;
+    auto condition = optimize(ifStatement.condition);
+    auto trueClause = optimize(ifStatement.trueClause);
+    auto falseClause = optimize(ifStatement.falseClause);
+
+    if (isLiteral(condition)) {
+        auto live = nodeAs<BooleansFalseAST>(condition) ? falseClause : trueClause;
+        // Tail recursion is detected by IfStatementAST only, so keep the node but drop dead branch
+        result = isCall(live) ? makeNode<IfStatementAST>(condition, live, live) : live;
+    } else if (condition != ifStatement.condition || trueClause != ifStatement.trueClause
+               || falseClause != ifStatement.falseClause) {
+        result = makeNode<IfStatementAST>(condition, trueClause, falseClause);
+    } else {
+        result = self;
+    }
+}
+
+void OptimizeVisitor::visitCondStatementAST(const CondStatementAST &cond) {
+    // cond is a chain of if statement, which can be evaluated directly
+    result = optimize(cond.ifStatement);
+}
+
+void OptimizeVisitor::visitLetStatementAST(const LetStatementAST &let) {
+    auto self = result;
+    vector<pExpr> value;
+    auto changed = optimizeAll(let.value, value);
+    auto expr = optimize(let.expr);
+    if (changed || expr != let.expr)
+        result = makeNode<LetStatementAST>(let.identifier, value, expr);
+    else
+        result = self;
+}
+
+void OptimizeVisitor::visitValueBindingAST(const ValueBindingAST &binding) {
+    auto self = result;
+    auto value = optimize(binding.value);
+    result = value != binding.value ? makeNode<ValueBindingAST>(binding.getIdentifier(), value) : self;
+}
+
+void OptimizeVisitor::visitLambdaAST(const LambdaAST &lambda) {
+    auto self = result;
+    vector<pExpr> expression;
+    result = optimizeAll(lambda.code->expression, expression) ?
+             makeNode<LambdaAST>(lambda.code->formalArgs, expression, lambda.code->location) : self;
+}
+
+void OptimizeVisitor::visitLambdaBindingAST(const LambdaBindingAST &binding) {
+    auto self = result;
+    vector<pExpr> expression;
+    result = optimizeAll(binding.lambda->code->expression, expression) ?
+             makeNode<LambdaBindingAST>(binding.getIdentifier(), binding.lambda->code->formalArgs, expression) : self;
+}
+
+void OptimizeVisitor::visitLambdaApplicationAST(const InvocationAST &invocation) {
+    auto self = result;
+    auto callable = optimize(invocation.callableObj);
+    vector<pExpr> args;
+    auto changed = optimizeAll(invocation.actualArgs, args);
+
+    auto id = nodeAs<IdentifierAST>(callable);
+    // Some builtins access the first argument without check, leave (car) to runtime as well
+    if (id && pureBuiltin.count(id->getId()) && !args.empty() && all_of(begin(args), end(args), isLiteral)) {
+        auto s = make_shared<context::Scope>();
+        // builtin steps out in apply
+        s->stepIntoFunc(id->getId());
+        try {
+            result = s->findSymbol(id->getId())->apply(args, s);
+            return;
+        } catch (RuntimeError &) {
+            // Leave the error to runtime
+            s->stepOutFunc();
+        }
+    }
+    InlineBuiltinAST::Op op;
+    if (id && InlineBuiltinAST::inlinable(id->getId(), args.size(), op))
+        result = makeNode<InlineBuiltinAST>(op, callable, args);
+    else if (changed || callable != invocation.callableObj)
+        result = makeNode<InvocationAST>(callable, args);
+    else
+        result = self;
+}
+
+pExpr visitor::optimize(const pExpr &expr) {
+    if (!OptimizeVisitor::enabled) return expr;
+    profiler::TraceScope trace{"parse", "optimize"};
+    OptimizeVisitor optimizer;
+    return optimizer.optimize(expr);
+}
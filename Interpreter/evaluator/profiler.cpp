@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <profiler.h>
+
+using namespace profiler;
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+    struct Stat {
+        size_t calls = 0;
+        nanoseconds self{0}, total{0};
+        size_t selfAllocs = 0, totalAllocs = 0;
+        // Number of unfinished calls, total is only updated by the outermost one
+        int active = 0;
+    };
+
+    // Node of call tree, for collapsed stacks
+    struct Node {
+        map<string, unique_ptr<Node>> children;
+        nanoseconds self{0};
+    };
+
+    struct Frame {
+        Stat *stat;
+        Node *node;
+        steady_clock::time_point start;
+        size_t allocs;
+        nanoseconds childTime;
+        size_t childAllocs;
+    };
+
+    unordered_map<string, Stat> stats;
+    unique_ptr<Node> root{new Node};
+    vector<Frame> frames;
+
+    void collapse(const Node &node, const string &path, ostream &os) {
+        for (const auto &child : node.children) {
+            auto childPath = path.empty() ? child.first : path + ";" + child.first;
+            auto us = duration_cast<microseconds>(child.second->self).count();
+            if (us > 0) os << childPath << " " << us << "\n";
+            collapse(*child.second, childPath, os);
+        }
+    }
+
+    double toMs(nanoseconds t) {
+        return duration_cast<duration<double, milli>>(t).count();
+    }
+}
+
+bool Profiler::enabled = false;
+
+void Profiler::enter(const std::string &name) {
+    auto &stat = stats[name];
+    stat.calls++;
+    stat.active++;
+    auto &parent = frames.empty() ? *root : *frames.back().node;
+    auto &node = parent.children[name];
+    if (!node) node.reset(new Node);
+    frames.push_back({&stat, node.get(), steady_clock::now(), allocationCount(), nanoseconds{0}, 0});
+}
+
+void Profiler::leave() {
+    // Frames may be left behind by an exception, so don't trust the stack to be balanced
+    if (frames.empty()) return;
+    auto elapsed = steady_clock::now() - frames.back().start;
+    auto allocs = allocationCount() - frames.back().allocs;
+    auto frame = frames.back();
+    frames.pop_back();
+
+    frame.stat->self += elapsed - frame.childTime;
+    frame.stat->selfAllocs += allocs - frame.childAllocs;
+    frame.node->self += elapsed - frame.childTime;
+    if (--frame.stat->active == 0) {
+        frame.stat->total += elapsed;
+        frame.stat->totalAllocs += allocs;
+    }
+    if (!frames.empty()) {
+        frames.back().childTime += elapsed;
+        frames.back().childAllocs += allocs;
+    }
+}
+
+void Profiler::reset() {
+    stats.clear();
+    frames.clear();
+    root.reset(new Node);
+}
+
+void Profiler::report(std::ostream &os) {
+    vector<pair<string, const Stat *>> sorted;
+    nanoseconds sum{0};
+    for (const auto &p : stats) {
+        sorted.emplace_back(p.first, &p.second);
+        sum += p.second.self;
+    }
+    sort(sorted.begin(), sorted.end(), [](const pair<string, const Stat *> &a, const pair<string, const Stat *> &b) {
+        return a.second->self > b.second->self;
+    });
+
+    os << setw(7) << "%time" << setw(12) << "self(ms)" << setw(12) << "total(ms)" << setw(10) << "calls"
+       << setw(12) << "self-alloc" << setw(12) << "total-alloc" << "  name\n";
+    os << fixed;
+    for (const auto &p : sorted) {
+        const auto &stat = *p.second;
+        auto percent = sum.count() ? 100.0 * stat.self.count() / sum.count() : 0.0;
+        os << setprecision(2) << setw(7) << percent
+           << setprecision(3) << setw(12) << toMs(stat.self) << setw(12) << toMs(stat.total)
+           << setw(10) << stat.calls << setw(12) << stat.selfAllocs << setw(12) << stat.totalAllocs
+           << "  " << p.first << "\n";
+    }
+    os.unsetf(ios_base::floatfield);
+}
+
+void Profiler::collapsedStacks(std::ostream &os) {
+    collapse(*root, "", os);
+}
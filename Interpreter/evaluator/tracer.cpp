@@ -0,0 +1,103 @@
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <tracer.h>
+
+using namespace profiler;
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+    struct Event {
+        const char *category;
+        string name, detail;
+        long long ts, dur;
+        int tid;
+    };
+
+    mutex eventsMutex;
+    vector<Event> events;
+
+    // Timestamps are relative to the loading of program
+    const steady_clock::time_point origin = steady_clock::now();
+
+    atomic<int> nextTid{1};
+
+    int currentTid() {
+        thread_local int tid = nextTid++;
+        return tid;
+    }
+
+    string escape(const string &str) {
+        string res;
+        for (auto c : str) {
+            if (c == '"' || c == '\\') {
+                res.push_back('\\');
+                res.push_back(c);
+            } else if (c == '\n') {
+                res += "\\n";
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                res.push_back(' ');
+            } else {
+                res.push_back(c);
+            }
+        }
+        return res;
+    }
+}
+
+bool Tracer::enabled = false;
+
+std::chrono::microseconds Tracer::threshold{100};
+
+void Tracer::record(const char *category, const std::string &name, const std::string &detail,
+                    steady_clock::time_point begin, steady_clock::duration dur) {
+    Event event{category, name, detail,
+                duration_cast<microseconds>(begin - origin).count(),
+                duration_cast<microseconds>(dur).count(), currentTid()};
+    lock_guard<mutex> lock{eventsMutex};
+    events.push_back(std::move(event));
+}
+
+void Tracer::clear() {
+    lock_guard<mutex> lock{eventsMutex};
+    events.clear();
+}
+
+std::size_t Tracer::size() {
+    lock_guard<mutex> lock{eventsMutex};
+    return events.size();
+}
+
+void Tracer::write(std::ostream &os) {
+    lock_guard<mutex> lock{eventsMutex};
+    os << "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); i++) {
+        const auto &e = events[i];
+        os << (i ? ",\n" : "\n")
+           << "{\"name\":\"" << escape(e.name) << "\",\"cat\":\"" << e.category
+           << "\",\"ph\":\"X\",\"ts\":" << e.ts << ",\"dur\":" << e.dur
+           << ",\"pid\":1,\"tid\":" << e.tid;
+        if (!e.detail.empty()) os << ",\"args\":{\"detail\":\"" << escape(e.detail) << "\"}";
+        os << "}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+TraceScope::TraceScope(const char *category, const std::string &name)
+    : active{Tracer::enabled}, category{category} {
+    if (active) {
+        this->name = name;
+        begin = steady_clock::now();
+    }
+}
+
+bool TraceScope::sampled() const {
+    return active && steady_clock::now() - begin >= Tracer::threshold;
+}
+
+TraceScope::~TraceScope() {
+    if (!active) return;
+    auto dur = steady_clock::now() - begin;
+    if (dur >= Tracer::threshold) Tracer::record(category, name, detail, begin, dur);
+}
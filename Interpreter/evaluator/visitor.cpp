@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 #include "visitor.h"
 
@@ -25,10 +26,35 @@ void DisplayVisitor::visitNilAST(const ast::NilAST &) {
     prettyPrint = "\'()";
 }
 
+void DisplayVisitor::visitVectorAST(const ast::VectorAST &vec) {
+    // vector-set! may make a vector contain itself
+    auto elements = vec.elements.get();
+    if (std::find(printing.begin(), printing.end(), elements) != printing.end()) {
+        prettyPrint = "#(...)";
+        return;
+    }
+    printing.push_back(elements);
+    string newPrint = "#(";
+    for (size_t i = 0; i < elements->size(); i++) {
+        (*elements)[i]->accept(*this);
+        newPrint += (i ? ", " : "") + prettyPrint;
+    }
+    printing.pop_back();
+    prettyPrint = newPrint + ")";
+}
+
+void DisplayVisitor::visitRestArgsAST(const ast::RestArgsAST &view) {
+    view.toList()->accept(*this);
+}
+
 void DisplayVisitor::visitLambdaAST(const ast::LambdaAST &) {
     prettyPrint = "#proceduce";
 }
 
+void DisplayVisitor::visitMemoizedAST(const ast::MemoizedAST &) {
+    prettyPrint = "#proceduce";
+}
+
 void DisplayVisitor::visitNumberAST(const ast::NumberAST &num) {
     ostringstream sout;
     sout << num.getValue();
@@ -2,6 +2,7 @@
 #define GI_AST_H
 #define APPLY_FUNC pExpr apply(const std::vector<pExpr> &actualArgs, pScope &) const override;
 
+#include <cassert>
 #include <exception>
 #include <fstream>
 #include <memory>
@@ -9,13 +10,24 @@
 #include <map>
 #include <vector>
 #include <easylogging++.h>
+#include <arena.h>
+#include <memstats.h>
+#include <inlineCache.h>
 
 namespace visitor {
     class NodeVisitor;
+
+    class OptimizeVisitor;
+
+    class EscapeVisitor;
+
+    class CaptureVisitor;
 }
 
 namespace context {
     class Scope;
+
+    class InternTable;
 }
 
 namespace ast {
@@ -27,8 +39,29 @@ namespace ast {
 
     using pExpr = std::shared_ptr<ExprAST>;
 
+    // Type of a node, for the classes evaluation tells apart; all others are OTHER.
+    // A node of a derived class has the kind of its base, e.g. InlineBuiltinAST is an INVOCATION.
+    enum class NodeKind : unsigned char {
+        OTHER, ALL_EXPR, FALSE, TRUE, NUMBER, IDENTIFIER, INVOCATION, TAIL_RECURSION_ARGS,
+        LOADING_FILE, PAIR, NIL, REST_ARGS, VECTOR, VALUE_BINDING, LAMBDA, LAMBDA_BINDING, MEMOIZED
+    };
+
     class ExprAST {
+        friend class context::InternTable;
+
     public:
+        explicit ExprAST(NodeKind k = NodeKind::OTHER) : nodeKind{k} {}
+
+        // A copy is a value of its own, never the canonical one
+        ExprAST(const ExprAST &other) : nodeKind{other.nodeKind} {}
+
+        virtual ~ExprAST() = default;
+
+        NodeKind kind() const { return nodeKind; }
+
+        // Whether this is the shared instance of its value, see context::InternTable
+        bool isCanonical() const { return canonical; }
+
         // Eval this AST node and return result. The node itself does not be changed.
         virtual pExpr eval(pScope &) const;
 
@@ -37,19 +70,47 @@ namespace ast {
         virtual pExpr apply(const std::vector<pExpr> &, pScope &) const;
 
         virtual void accept(visitor::NodeVisitor &) const;
+
+    private:
+        NodeKind nodeKind;
+        bool canonical = false;
     };
 
+    // expr as a T (which has a KIND) if it is one, else nullptr. Unlike dynamic_cast it compares
+    // the kind only; debug builds check it against RTTI.
+    template<typename T>
+    const T *nodeAs(const ExprAST *expr) {
+        if (!expr || expr->kind() != T::KIND) return nullptr;
+        assert(dynamic_cast<const T *>(expr));
+        return static_cast<const T *>(expr);
+    }
+
+    template<typename T>
+    const T *nodeAs(const pExpr &expr) {
+        return nodeAs<T>(expr.get());
+    }
 
-    class EvalResult : public ExprAST {
+    // Like nodeAs, for a node to be kept
+    template<typename T>
+    std::shared_ptr<T> nodeCast(const pExpr &expr) {
+        return nodeAs<T>(expr.get()) ? std::static_pointer_cast<T>(expr) : nullptr;
+    }
+
+
+    class EvalResult : public ExprAST, private profiler::Counted<EvalResult> {
     public:
         std::vector<pExpr> result;
 
         explicit EvalResult(std::vector<pExpr> vec) : result(std::move(vec)) {}
     };
 
-    class AllExprAST : public ExprAST {
+    class AllExprAST : public ExprAST, private profiler::Counted<AllExprAST> {
+        friend class visitor::OptimizeVisitor;
+
     public:
-        explicit AllExprAST(std::vector<std::shared_ptr<ExprAST>> v) : exprVec{std::move(v)} {}
+        static const NodeKind KIND = NodeKind::ALL_EXPR;
+
+        explicit AllExprAST(std::vector<std::shared_ptr<ExprAST>> v) : ExprAST(KIND), exprVec{std::move(v)} {}
 
         void accept(visitor::NodeVisitor &) const override;
 
@@ -63,23 +124,33 @@ namespace ast {
         std::vector<std::shared_ptr<ExprAST>> exprVec;
     };
 
-    class BooleansFalseAST : public ExprAST {
+    class BooleansFalseAST : public ExprAST, private profiler::Counted<BooleansFalseAST> {
     public:
+        static const NodeKind KIND = NodeKind::FALSE;
+
+        BooleansFalseAST() : ExprAST(KIND) {}
+
         void accept(visitor::NodeVisitor &visitor) const override;
 
         pExpr getPointer() const override;
     };
 
-    class BooleansTrueAST : public ExprAST {
+    class BooleansTrueAST : public ExprAST, private profiler::Counted<BooleansTrueAST> {
     public:
+        static const NodeKind KIND = NodeKind::TRUE;
+
+        BooleansTrueAST() : ExprAST(KIND) {}
+
         void accept(visitor::NodeVisitor &visitor) const override;
 
         pExpr getPointer() const override;
     };
 
-    class NumberAST : public ExprAST {
+    class NumberAST : public ExprAST, private profiler::Counted<NumberAST> {
     public:
-        explicit NumberAST(double n) : value{n} {}
+        static const NodeKind KIND = NodeKind::NUMBER;
+
+        explicit NumberAST(double n) : ExprAST(KIND), value{n} {}
 
         void accept(visitor::NodeVisitor &visitor) const override;
 
@@ -91,13 +162,15 @@ namespace ast {
         double value;
     };
 
-    class IdentifierAST : public ExprAST {
+    class IdentifierAST : public ExprAST, private profiler::Counted<IdentifierAST> {
     public:
-        explicit IdentifierAST(std::string tid) : id{std::move(tid)} {}
+        static const NodeKind KIND = NodeKind::IDENTIFIER;
+
+        explicit IdentifierAST(std::string tid) : ExprAST(KIND), id{std::move(tid)} {}
 
         void accept(visitor::NodeVisitor &visitor) const override;
 
-        std::string getId() const { return id; }
+        const std::string &getId() const { return id; }
 
         pExpr getPointer() const override;
 
@@ -108,10 +181,18 @@ namespace ast {
     };
 
     // deal with anonymous lambda invocation directly and normal function call
-    class InvocationAST : public ExprAST {
+    class InvocationAST : public ExprAST, private profiler::Counted<InvocationAST> {
         friend class IfStatementAST;
 
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
+        friend class visitor::CaptureVisitor;
+
     public:
+        static const NodeKind KIND = NodeKind::INVOCATION;
+
         void accept(visitor::NodeVisitor &visitor) const override;
 
         InvocationAST(const std::shared_ptr<ExprAST> &lam,
@@ -121,19 +202,59 @@ namespace ast {
 
         std::shared_ptr<ExprAST> eval(std::shared_ptr<Scope> &ss) const override;
 
-    private:
+        const std::shared_ptr<ExprAST> &getCallable() const { return callableObj; }
+
+    protected:
         std::shared_ptr<ExprAST> callableObj;
         std::vector<std::shared_ptr<ExprAST>> actualArgs;
+        // Builtin the callable names, if any; nothing can rebind it
+        pExpr builtin;
+
+    private:
+        context::InlineCache cache;
     };
 
-    class TailRecursionArgs : public ExprAST {
+    // Call of car, cdr, cons, + or * made by visitor::OptimizeVisitor, which does the operation
+    // itself instead of a call of the builtin. Operands of other types take the builtin call,
+    // so errors are reported the same way. It's an invocation to visitors.
+    class InlineBuiltinAST : public InvocationAST, private profiler::Counted<InlineBuiltinAST> {
     public:
-        explicit TailRecursionArgs(std::vector<pExpr> actualArgs) : actualArgs{std::move(actualArgs)} {}
+        enum class Op {
+            CAR, CDR, CONS, ADD, MULTIPLY
+        };
+
+        InlineBuiltinAST(Op op, const std::shared_ptr<ExprAST> &lam,
+                         const std::vector<std::shared_ptr<ExprAST>> &args);
+
+        // Operation done inline for a call of builtin name with argc arguments, if any
+        static bool inlinable(const std::string &name, std::size_t argc, Op &op);
+
+        pExpr getPointer() const override;
+
+        std::shared_ptr<ExprAST> eval(std::shared_ptr<Scope> &ss) const override;
+
+    private:
+        pExpr callBuiltin(const pExpr &first, const pExpr &second, pScope &ss) const;
+
+        Op op;
+    };
+
+    class TailRecursionArgs : public ExprAST, private profiler::Counted<TailRecursionArgs> {
+    public:
+        static const NodeKind KIND = NodeKind::TAIL_RECURSION_ARGS;
+
+        explicit TailRecursionArgs(std::vector<pExpr> actualArgs) : ExprAST(KIND), actualArgs{std::move(actualArgs)} {}
 
         std::vector<pExpr> actualArgs;
     };
 
-    class IfStatementAST : public ExprAST {
+    class IfStatementAST : public ExprAST, private profiler::Counted<IfStatementAST> {
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
+        friend class visitor::CaptureVisitor;
+
     public:
         IfStatementAST(const std::shared_ptr<ExprAST> &c,
                        const std::shared_ptr<ExprAST> &t,
@@ -155,7 +276,13 @@ namespace ast {
         std::shared_ptr<ExprAST> eval(const std::shared_ptr<ExprAST> &, std::shared_ptr<Scope> &) const;
     };
 
-    class CondStatementAST : public ExprAST {
+    class CondStatementAST : public ExprAST, private profiler::Counted<CondStatementAST> {
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
+        friend class visitor::CaptureVisitor;
+
     public:
         CondStatementAST(const std::vector<std::shared_ptr<ExprAST>> &,
                          const std::vector<std::shared_ptr<ExprAST>> &);
@@ -170,7 +297,11 @@ namespace ast {
         std::shared_ptr<ExprAST> ifStatement;
     };
 
-    class LetStatementAST : public ExprAST {
+    class LetStatementAST : public ExprAST, private profiler::Counted<LetStatementAST> {
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
     public:
         LetStatementAST(std::vector<std::shared_ptr<ExprAST>> id,
                         std::vector<std::shared_ptr<ExprAST>> v,
@@ -188,9 +319,11 @@ namespace ast {
         std::shared_ptr<ExprAST> expr;
     };
 
-    class LoadingFileAST : public ExprAST {
+    class LoadingFileAST : public ExprAST, private profiler::Counted<LoadingFileAST> {
     public:
-        explicit LoadingFileAST(std::string f) : filename{std::move(f)} {}
+        static const NodeKind KIND = NodeKind::LOADING_FILE;
+
+        explicit LoadingFileAST(std::string f) : ExprAST(KIND), filename{std::move(f)} {}
 
         void accept(visitor::NodeVisitor &visitor) const override;
 
@@ -205,10 +338,12 @@ namespace ast {
     };
 
 
-    class PairAST : public ExprAST {
+    class PairAST : public ExprAST, private profiler::Counted<PairAST> {
     public:
+        static const NodeKind KIND = NodeKind::PAIR;
+
         PairAST(const std::shared_ptr<ExprAST> &f,
-                const std::shared_ptr<ExprAST> &s) : data{f, s} {}
+                const std::shared_ptr<ExprAST> &s) : ExprAST(KIND), data{f, s} {}
 
         void accept(visitor::NodeVisitor &visitor) const override;
 
@@ -220,17 +355,67 @@ namespace ast {
 
     };
 
-    class NilAST : public ExprAST {
+    class NilAST : public ExprAST, private profiler::Counted<NilAST> {
     public:
+        static const NodeKind KIND = NodeKind::NIL;
+
+        NilAST() : ExprAST(KIND) {}
+
         void accept(visitor::NodeVisitor &visitor) const override;
 
         pExpr getPointer() const override;
     };
 
+    // Rest arguments of a call, bound to the `.` parameter instead of a list when the lambda body
+    // only takes car, cdr and null? of it (see visitor::EscapeVisitor). It's never empty.
+    // The arguments are copied once into a vector owned by the views, and a view made by cdr
+    // shares it. A function called by the lambda may still find the parameter by dynamic scope,
+    // so Scope::findSymbol, list builtins and DisplayVisitor take a view as the list it stands for.
+    class RestArgsAST : public ExprAST, private profiler::Counted<RestArgsAST> {
+    public:
+        static const NodeKind KIND = NodeKind::REST_ARGS;
+
+        // args[offset] onwards
+        RestArgsAST(std::shared_ptr<const std::vector<pExpr>> args, std::size_t offset) :
+            ExprAST(KIND), args{std::move(args)}, offset{offset} {}
+
+        const pExpr &first() const { return (*args)[offset]; }
+
+        // Next view, or nil at the end
+        pExpr rest() const;
+
+        // The list this view stands for
+        pExpr toList() const;
+
+        void accept(visitor::NodeVisitor &) const override;
+
+        pExpr getPointer() const override;
+
+    private:
+        std::shared_ptr<const std::vector<pExpr>> args;
+        std::size_t offset;
+    };
+
+    // Fixed-size array of values. Copies made by eval/getPointer share elements,
+    // so vector-set! is seen through every reference to the vector.
+    class VectorAST : public ExprAST, private profiler::Counted<VectorAST> {
+    public:
+        static const NodeKind KIND = NodeKind::VECTOR;
+
+        explicit VectorAST(std::vector<pExpr> v)
+            : ExprAST(KIND), elements{std::make_shared<std::vector<pExpr>>(std::move(v))} {}
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+
+        std::shared_ptr<std::vector<pExpr>> elements;
+    };
+
 
     class BindingAST : public ExprAST {
     public:
-        explicit BindingAST(std::string id) : identifier{std::move(id)} {}
+        BindingAST(std::string id, NodeKind k) : ExprAST(k), identifier{std::move(id)} {}
 
         void accept(visitor::NodeVisitor &visitor) const override;
 
@@ -244,8 +429,14 @@ namespace ast {
         std::string identifier;
     };
 
-    class ValueBindingAST : public BindingAST {
+    class ValueBindingAST : public BindingAST, private profiler::Counted<ValueBindingAST> {
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
     public:
+        static const NodeKind KIND = NodeKind::VALUE_BINDING;
+
         ValueBindingAST(const std::string &id,
                         const std::shared_ptr<ExprAST> &v);
 
@@ -259,13 +450,22 @@ namespace ast {
         std::shared_ptr<ExprAST> value;
     };
 
-    class LambdaAST : public ExprAST {
+    class LambdaAST : public ExprAST, private profiler::Counted<LambdaAST> {
         friend class LambdaBindingAST;
 
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
+        friend class visitor::CaptureVisitor;
+
     public:
         APPLY_FUNC
 
-        LambdaAST(std::vector<std::string> v, std::vector<std::shared_ptr<ExprAST>> expr);
+        static const NodeKind KIND = NodeKind::LAMBDA;
+
+        LambdaAST(std::vector<std::string> v, std::vector<std::shared_ptr<ExprAST>> expr,
+                  std::string loc = "");
 
         void accept(visitor::NodeVisitor &visitor) const override;
 
@@ -275,21 +475,48 @@ namespace ast {
 
         pExpr getPointer() const override;
 
+        // Where the lambda is defined, e.g. "Shape.scm:20". Empty if unknown.
+        const std::string &getLocation() const { return code->location; }
+
     private:
-        std::vector<std::string> formalArgs;
-        std::vector<std::shared_ptr<ExprAST>> expression;
+        // What a lambda and all closures made of it share, never changed once analyzed
+        struct Code {
+            std::vector<std::string> formalArgs;
+            std::vector<std::shared_ptr<ExprAST>> expression;
+            std::string location;
+            bool hasSubroutine = false;
+            // Rest parameter is bound to RestArgsAST since it doesn't escape, see visitor::EscapeVisitor
+            bool restView = false;
+            // Closures capture values of these free variables only, see visitor::CaptureVisitor
+            bool flat = false;
+            std::vector<std::string> freeVariables;
+        };
+
+        // Closure of code
+        explicit LambdaAST(std::shared_ptr<const Code> c) : ExprAST(KIND), code{std::move(c)} {}
+
+        // Bind free variables of a flat closure, false if any of them is not found in lexical scopes
+        bool capture(const pScope &ss) const;
+
+        std::shared_ptr<const Code> code;
         mutable pScope context;
     };
 
 
-    class LambdaBindingAST : public BindingAST {
+    class LambdaBindingAST : public BindingAST, private profiler::Counted<LambdaBindingAST> {
+        friend class visitor::OptimizeVisitor;
+
+        friend class visitor::EscapeVisitor;
+
     public:
+        static const NodeKind KIND = NodeKind::LAMBDA_BINDING;
+
         void accept(visitor::NodeVisitor &visitor) const override;
 
         LambdaBindingAST(const std::string &id,
                          const std::vector<std::string> &v,
                          const std::vector<std::shared_ptr<ExprAST>> &expr) :
-            BindingAST(id), lambda{std::make_shared<LambdaAST>(v, expr)} {}
+            BindingAST(id, KIND), lambda{parser::makeNode<LambdaAST>(v, expr)} {}
 
         std::shared_ptr<ExprAST> eval(std::shared_ptr<Scope> &ss) const override;
 
@@ -0,0 +1,96 @@
+#ifndef GI_ARENA_H
+#define GI_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace parser {
+    // Bump-pointer arena for AST nodes of one parse unit.
+    // Memory is never freed individually; all blocks are released together when the last node
+    // allocated from this arena dies (each node holds the arena through its allocator).
+    class Arena {
+    public:
+        Arena() {}
+
+        Arena(const Arena &) = delete;
+
+        Arena &operator=(const Arena &) = delete;
+
+        void *allocate(std::size_t size, std::size_t align);
+
+        // Bytes handed out and number of blocks requested from system
+        std::size_t size() const { return allocated; }
+
+        std::size_t blockCount() const { return blocks.size(); }
+
+        // Arena used by parser in current thread, nullptr if none
+        static const std::shared_ptr<Arena> &current();
+
+    private:
+        void newBlock(std::size_t size);
+
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char *cur = nullptr, *end = nullptr;
+        std::size_t nextBlockSize = 4096, allocated = 0;
+    };
+
+    // One parse unit: nodes created by the parser in current thread come from one arena.
+    // Nested scopes share the outermost one.
+    class ArenaScope {
+    public:
+        ArenaScope();
+
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope &) = delete;
+
+        ArenaScope &operator=(const ArenaScope &) = delete;
+
+        const std::shared_ptr<Arena> &arena() const { return Arena::current(); }
+
+    private:
+        bool owner;
+    };
+
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        explicit ArenaAllocator(const std::shared_ptr<Arena> &a) : arena{a} {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) : arena{other.arena} {}
+
+        T *allocate(std::size_t n) {
+            return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, std::size_t) {}
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+    private:
+        template<typename U> friend
+        class ArenaAllocator;
+
+        std::shared_ptr<Arena> arena;
+    };
+
+    // Create AST node in the arena of current parse unit, or on heap outside of parse unit.
+    template<typename T, typename... Args>
+    std::shared_ptr<T> makeNode(Args &&... args) {
+        const auto &arena = Arena::current();
+        if (arena)
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+        else
+            return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+}
+
+#endif //GI_ARENA_H
@@ -2,9 +2,10 @@
 #define LSI_BUILTINAST_H
 
 #include <AST.h>
+#include <memoCache.h>
 
 namespace ast {
-    class BuiltinConsAST : public ExprAST {
+    class BuiltinConsAST : public ExprAST, private profiler::Counted<BuiltinConsAST> {
     public:
         APPLY_FUNC
 
@@ -13,7 +14,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinCarAST : public ExprAST {
+    class BuiltinCarAST : public ExprAST, private profiler::Counted<BuiltinCarAST> {
     public:
         APPLY_FUNC
 
@@ -22,7 +23,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinCdrAST : public ExprAST {
+    class BuiltinCdrAST : public ExprAST, private profiler::Counted<BuiltinCdrAST> {
     public:
         APPLY_FUNC
 
@@ -31,7 +32,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinAddAST : public ExprAST {
+    class BuiltinAddAST : public ExprAST, private profiler::Counted<BuiltinAddAST> {
     public:
         APPLY_FUNC
 
@@ -40,7 +41,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinMultiplyAST : public ExprAST {
+    class BuiltinMultiplyAST : public ExprAST, private profiler::Counted<BuiltinMultiplyAST> {
     public:
         APPLY_FUNC
 
@@ -49,7 +50,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinListAST : public ExprAST {
+    class BuiltinListAST : public ExprAST, private profiler::Counted<BuiltinListAST> {
     public:
 
         APPLY_FUNC
@@ -59,7 +60,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinNullAST : public ExprAST {
+    class BuiltinNullAST : public ExprAST, private profiler::Counted<BuiltinNullAST> {
     public:
         APPLY_FUNC
 
@@ -68,7 +69,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinLessThanAST : public ExprAST {
+    class BuiltinLessThanAST : public ExprAST, private profiler::Counted<BuiltinLessThanAST> {
     public:
         APPLY_FUNC
 
@@ -77,7 +78,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinOppositeAST : public ExprAST {
+    class BuiltinOppositeAST : public ExprAST, private profiler::Counted<BuiltinOppositeAST> {
     public:
         APPLY_FUNC
 
@@ -86,7 +87,7 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
-    class BuiltinReciprocalAST : public ExprAST {
+    class BuiltinReciprocalAST : public ExprAST, private profiler::Counted<BuiltinReciprocalAST> {
     public:
         APPLY_FUNC
 
@@ -95,8 +96,209 @@ namespace ast {
         pExpr getPointer() const override;
     };
 
+    // (#mem-stats): print MemoryStats report to stderr, return the number of live objects
+    class BuiltinMemStatsAST : public ExprAST, private profiler::Counted<BuiltinMemStatsAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#map seq op): list of (op x) for x in seq. Like map in Base.scm, op is applied from the last element
+    class BuiltinMapAST : public ExprAST, private profiler::Counted<BuiltinMapAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#append l ...): lists joined; the last one is shared, not copied
+    class BuiltinAppendAST : public ExprAST, private profiler::Counted<BuiltinAppendAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#reverse l)
+    class BuiltinReverseAST : public ExprAST, private profiler::Counted<BuiltinReverseAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#length l)
+    class BuiltinLengthAST : public ExprAST, private profiler::Counted<BuiltinLengthAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#reduce seq op init): (op ... (op (op init x1) x2) ... xn)
+    class BuiltinReduceAST : public ExprAST, private profiler::Counted<BuiltinReduceAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#filter seq pred): elements of seq for which pred isn't #f, in order
+    class BuiltinFilterAST : public ExprAST, private profiler::Counted<BuiltinFilterAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#make-vector n [fill]): vector of n fill, 0 by default
+    class BuiltinMakeVectorAST : public ExprAST, private profiler::Counted<BuiltinMakeVectorAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#vector x ...)
+    class BuiltinVectorAST : public ExprAST, private profiler::Counted<BuiltinVectorAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#vector-ref v i)
+    class BuiltinVectorRefAST : public ExprAST, private profiler::Counted<BuiltinVectorRefAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#vector-set! v i x): returns an unspecified value
+    class BuiltinVectorSetAST : public ExprAST, private profiler::Counted<BuiltinVectorSetAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#vector-length v)
+    class BuiltinVectorLengthAST : public ExprAST, private profiler::Counted<BuiltinVectorLengthAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#vector-map v op): new vector of (op x), like map takes the sequence first
+    class BuiltinVectorMapAST : public ExprAST, private profiler::Counted<BuiltinVectorMapAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#vector->list v)
+    class BuiltinVectorToListAST : public ExprAST, private profiler::Counted<BuiltinVectorToListAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#list->vector l)
+    class BuiltinListToVectorAST : public ExprAST, private profiler::Counted<BuiltinListToVectorAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#equal? a b): same structure, see context::InternTable::equal
+    class BuiltinEqualAST : public ExprAST, private profiler::Counted<BuiltinEqualAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // Function made by (memoize f [capacity]): calls f unless a call with the same arguments
+    // has been made before, see context::MemoCache. Copies share the cache.
+    class MemoizedAST : public ExprAST, private profiler::Counted<MemoizedAST> {
+    public:
+        APPLY_FUNC
+
+        static const NodeKind KIND = NodeKind::MEMOIZED;
+
+        MemoizedAST(pExpr f, std::size_t capacity)
+            : ExprAST(KIND), function{std::move(f)}, cache{std::make_shared<context::MemoCache>(capacity)} {}
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+
+        const context::MemoCache &getCache() const { return *cache; }
+
+    private:
+        pExpr function;
+        std::shared_ptr<context::MemoCache> cache;
+    };
+
+    // (#memoize f [capacity])
+    class BuiltinMemoizeAST : public ExprAST, private profiler::Counted<BuiltinMemoizeAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
+
+    // (#memo-stats f): (hits . misses) of memoized f
+    class BuiltinMemoStatsAST : public ExprAST, private profiler::Counted<BuiltinMemoStatsAST> {
+    public:
+        APPLY_FUNC
+
+        void accept(visitor::NodeVisitor &visitor) const override;
+
+        pExpr getPointer() const override;
+    };
 
-    class BuiltinDrawAST : public ExprAST {
+    class BuiltinDrawAST : public ExprAST, private profiler::Counted<BuiltinDrawAST> {
     public:
         void accept(visitor::NodeVisitor &visitor) const override;
 
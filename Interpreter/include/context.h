@@ -1,11 +1,16 @@
 #ifndef GI_CONTEXT_H
 #define GI_CONTEXT_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <stack>
 #include <unordered_map>
 #include <set>
+#include <utility>
+#include <vector>
+#include <memstats.h>
 
 namespace ast {
     class ExprAST;
@@ -18,26 +23,36 @@ namespace context {
 
     using pExpr = std::shared_ptr<ast::ExprAST>;
 
-    class Scope {
+    class Scope : private profiler::Counted<Scope> {
     public:
 
         Scope();
 
         void addSymbol(const std::string &id, pExpr ptr);
 
+        // Bind a parameter of the call this scope is made for, see params
+        void addParam(const std::string &id, pExpr ptr);
+
         pExpr findSymbol(const std::string &) const;
 
+        // Symbol bound in this scope itself, not in builtins or parent scopes
+        pExpr findLocal(const std::string &) const;
+
+        // Parameter of this scope, nullptr if id isn't one
+        pExpr findParam(const std::string &) const;
+
         void setDynamicScope(const std::shared_ptr<Scope> &);
 
         void setLexicalScope(const std::shared_ptr<Scope> &);
 
-        void stepIntoAnonymousFunc();
+        // location is where the lambda is defined, see LambdaAST::getLocation
+        void stepIntoAnonymousFunc(const std::string &location = "");
 
         void stepIntoFunc(const std::string &name);
 
         void stepOutFunc();
 
-        std::string currentFunc() const;
+        const std::string &currentFunc() const;
 
         bool count(const std::string &str) const;
 
@@ -49,11 +64,26 @@ namespace context {
 
         std::unordered_map<std::string, std::shared_ptr<ast::ExprAST>> symtab;
 
+        // Parameters, looked up before symtab. A call has few of them, so a linear search beats hashing,
+        // and the slots (names included) are kept when the scope is cleared for reuse by FramePool.
+        std::vector<std::pair<std::string, pExpr>> params;
+        std::size_t paramCount = 0;
+
         std::shared_ptr<Scope> dynamicScope, lexicalScope;
 
-        static std::stack<std::string> callTrace;
+        // Unique among all scopes, renewed when the scope is cleared for reuse. Names a scope
+        // in InlineCache, where the address alone may be that of a later scope.
+        std::uint64_t serial;
+
+        // Whether this scope has been made the lexical or dynamic parent of another. Only then
+        // may a lookup cached by InlineCache have gone through it, so only then does a definition
+        // here invalidate the cache. Atomic, since a shared parent is marked by parallel calls.
+        std::atomic<bool> hasChildren{false};
+
+        // Per thread, so that scopes sharing a read-only parent can be evaluated in parallel
+        static thread_local std::stack<std::string> callTrace;
 
-        static int anonymousId;
+        static thread_local int anonymousId;
 
         static const std::unordered_map<std::string, std::shared_ptr<ast::ExprAST>> builtinFunc;
     };
@@ -0,0 +1,19 @@
+#ifndef GI_EMBEDDEDLIB_H
+#define GI_EMBEDDEDLIB_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace embedded {
+    // Scheme stdlib compiled into the interpreter: (filename, source) in loading order.
+    // The table is generated at build time from Scheme/stdlib by cmake/embedStdlib.cmake.
+    const std::vector<std::pair<std::string, std::string>> &libraries();
+
+    bool contains(const std::string &name);
+
+    // Source of an embedded file such as "Base.scm". Throw if it is not embedded.
+    const std::string &source(const std::string &name);
+}
+
+#endif //GI_EMBEDDEDLIB_H
@@ -0,0 +1,96 @@
+#ifndef GI_ESCAPE_H
+#define GI_ESCAPE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <AST.h>
+#include <visitor.h>
+
+namespace visitor {
+    // Escape analysis of the rest parameter of a lambda. It doesn't escape if it's only passed to car,
+    // cdr and null?, or to a parameter of an inner function (defined at the top of lambda body) which
+    // doesn't let it escape either, e.g. `args` of `and` in Base.scm. Then LambdaAST binds
+    // a RestArgsAST to it rather than a list. The analysis is conservative: any other use, rebinding
+    // a name it relies on, or loading a file in the body, counts as escaping.
+    class EscapeVisitor : public NodeVisitor {
+    public:
+        // lambda must have a rest parameter
+        static bool restEscapes(const ast::LambdaAST &);
+
+        void visitIdentifierAST(const ast::IdentifierAST &) override;
+
+        void visitIfStatementAST(const ast::IfStatementAST &) override;
+
+        void visitCondStatementAST(const ast::CondStatementAST &) override;
+
+        void visitLetStatementAST(const ast::LetStatementAST &) override;
+
+        void visitLoadingFileAST(const ast::LoadingFileAST &) override;
+
+        void visitPairAST(const ast::PairAST &) override;
+
+        void visitValueBindingAST(const ast::ValueBindingAST &) override;
+
+        void visitLambdaAST(const ast::LambdaAST &) override;
+
+        void visitLambdaBindingAST(const ast::LambdaBindingAST &) override;
+
+        void visitLambdaApplicationAST(const ast::InvocationAST &) override;
+
+    private:
+        // Whether expr is the variable tracked, or cdr of one
+        bool isView(const ast::pExpr &) const;
+
+        void bind(const std::string &);
+
+        std::string var;
+        bool escaped = false;
+        // Times each name is bound in lambda, counted in the first pass only
+        bool counting = true;
+        std::map<std::string, int> bindings;
+        // Calls the variable is passed to, as function name and argument position
+        std::set<std::pair<std::string, std::size_t>> passed;
+    };
+
+    // Free variable analysis for flat closures. A lambda is flat if its body has no nested lambda,
+    // let, define or load. Its closures then capture values of its free variables only, rather than
+    // keeping the whole scope alive, see LambdaAST::capture. That holds for free variables bound
+    // to parameters; if any is bound by a definition, which may be rebound, the scope is kept.
+    class CaptureVisitor : public NodeVisitor {
+    public:
+        // Whether lambda is flat; if so, its free variables are appended to vars
+        static bool freeVariables(const ast::LambdaAST &, std::vector<std::string> &vars);
+
+        void visitIdentifierAST(const ast::IdentifierAST &) override;
+
+        void visitIfStatementAST(const ast::IfStatementAST &) override;
+
+        void visitCondStatementAST(const ast::CondStatementAST &) override;
+
+        void visitLetStatementAST(const ast::LetStatementAST &) override;
+
+        void visitLoadingFileAST(const ast::LoadingFileAST &) override;
+
+        void visitPairAST(const ast::PairAST &) override;
+
+        void visitValueBindingAST(const ast::ValueBindingAST &) override;
+
+        void visitLambdaAST(const ast::LambdaAST &) override;
+
+        void visitLambdaBindingAST(const ast::LambdaBindingAST &) override;
+
+        void visitLambdaApplicationAST(const ast::InvocationAST &) override;
+
+    private:
+        explicit CaptureVisitor(std::vector<std::string> &v) : vars{v} {}
+
+        std::set<std::string> params;
+        std::vector<std::string> &vars;
+        bool flat = true;
+    };
+}
+
+#endif //GI_ESCAPE_H
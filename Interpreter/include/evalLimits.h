@@ -0,0 +1,81 @@
+#ifndef GI_EVALLIMITS_H
+#define GI_EVALLIMITS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <profiler.h>
+
+namespace context {
+    // Stop an evaluation running in another thread. Copies share the same flag.
+    class CancelToken {
+    public:
+        void cancel() { flag->store(true, std::memory_order_relaxed); }
+
+        bool cancelled() const { return flag->load(std::memory_order_relaxed); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+    };
+
+    // Resources an evaluation may use, 0 means unlimited
+    struct Limits {
+        // Function calls, including each iteration of tail recursion
+        unsigned long steps = 0;
+        // Nested function calls
+        std::size_t depth = 0;
+        // Bytes allocated and not freed since the limits are set
+        std::size_t heap = 0;
+        std::chrono::milliseconds time{0};
+        // Checked like the limits above, exception::Cancelled is thrown once it's cancelled
+        CancelToken cancel;
+    };
+
+    // Enforce limits on evaluation in current thread while alive; exception::LimitExceeded is thrown
+    // once any of them is exceeded. Limits are checked every CHECK_INTERVAL steps, so depth, heap
+    // and time may go a bit beyond before the check; steps are exact. These checks are also the
+    // points where an evaluation in a background thread notices it's cancelled.
+    // On destruction, call trace is unwound to where it was, so the thread can evaluate again.
+    class LimitGuard {
+    public:
+        explicit LimitGuard(const Limits &);
+
+        LimitGuard(const LimitGuard &) = delete;
+
+        LimitGuard &operator=(const LimitGuard &) = delete;
+
+        ~LimitGuard();
+
+        // Called by evaluator on each step
+        static void step() {
+            if (--countdown <= 0) check();
+        }
+
+        // Called before a single allocation of n bytes, such as a big vector, which the checks
+        // between steps would only notice once it's made
+        static void reserve(std::size_t n);
+
+        static const long CHECK_INTERVAL = 256;
+
+    private:
+        static void check();
+
+        static thread_local long countdown;
+
+        static thread_local LimitGuard *current;
+
+        Limits limits;
+        LimitGuard *previous;
+        std::size_t traceDepth;
+        unsigned long steps = 0;
+        // Steps done before countdown is reset
+        long batch = 0;
+        // On while there is a heap limit
+        profiler::AllocationCounting counting;
+        long long heapBase;
+        std::chrono::steady_clock::time_point deadline;
+    };
+}
+
+#endif //GI_EVALLIMITS_H
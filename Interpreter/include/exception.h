@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <exception>
+#include <stdexcept>
 
 namespace exception {
     class RuntimeError : public std::runtime_error {
@@ -46,6 +47,20 @@ namespace exception {
         explicit MissBracket(const std::string &what_arg) : RuntimeError(what_arg) {
         }
     };
+
+    // Evaluation exceeds context::Limits; the scope may be left half updated, so drop it
+    class LimitExceeded : public RuntimeError {
+    public:
+        explicit LimitExceeded(const std::string &what_arg) : RuntimeError(what_arg) {
+        }
+    };
+
+    // Evaluation stopped through context::CancelToken; like LimitExceeded, drop the scope
+    class Cancelled : public RuntimeError {
+    public:
+        explicit Cancelled(const std::string &what_arg) : RuntimeError(what_arg) {
+        }
+    };
 }
 
 #endif //GI_EXCEPTION_H
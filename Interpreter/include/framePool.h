@@ -0,0 +1,41 @@
+#ifndef GI_FRAMEPOOL_H
+#define GI_FRAMEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <context.h>
+
+namespace context {
+    // Per-thread pool of activation frames: scopes of calls and vectors of evaluated arguments.
+    // A frame is recycled when its call returns, unless a closure still refers to its scope,
+    // so calls which don't let their frame escape reuse memory instead of allocating it.
+    class FramePool {
+    public:
+        // Empty scope for a call, a recycled one if any
+        static pScope scope();
+
+        // Give back scope of a finished call. It's kept for reuse only if nothing else refers to it,
+        // and so are its lexical parents that were only referred by it; either way, s is empty afterwards.
+        static void recycle(pScope &s);
+
+        // Evaluated arguments of a call, taken from the pool and given back on destruction
+        class Args {
+        public:
+            Args();
+
+            Args(const Args &) = delete;
+
+            Args &operator=(const Args &) = delete;
+
+            ~Args();
+
+            std::vector<pExpr> values;
+        };
+
+        // Scopes and argument vectors kept per thread at most
+        static const std::size_t CAPACITY = 64;
+    };
+}
+
+#endif //GI_FRAMEPOOL_H
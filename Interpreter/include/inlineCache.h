@@ -0,0 +1,47 @@
+#ifndef GI_INLINECACHE_H
+#define GI_INLINECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <context.h>
+
+namespace context {
+    // Cache of the function a call site resolves its callee name to, see InvocationAST::eval.
+    // Scopes are dynamic, so what a name resolves to depends on the scope it's looked up from.
+    // Beyond the current call, that is the lexical parent of the call's scope, whose bindings only
+    // change by a definition: the cache holds while the parent is the same scope and nothing has
+    // been defined since in a scope that is a parent of another, see Scope::hasChildren.
+    // Names found through the caller (dynamic scope) aren't cached.
+    // Entries are kept per thread, so that sites shared by parallel renders need no locking.
+    // They refer to callees weakly, so that an entry left on another thread by a site that is gone
+    // keeps nothing alive.
+    class InlineCache {
+    public:
+        InlineCache();
+
+        // A copy of a node is another call site
+        InlineCache(const InlineCache &);
+
+        InlineCache &operator=(const InlineCache &) = delete;
+
+        ~InlineCache();
+
+        // What id is bound to as seen from ss, builtins excepted; nullptr if unbound
+        pExpr lookup(const std::string &id, const pScope &ss) const;
+
+        // Called whenever a binding a cached lookup may have found is added or changed
+        static void invalidate();
+
+        // Number never given out before, by any thread. Identifies a scope, see Scope::serial
+        static std::uint64_t stamp();
+
+    private:
+        // Index of the site in per-thread entries, reused once the site is gone
+        std::size_t site;
+        // Tells entries of the site from those of a former site with the same index
+        std::uint64_t generation;
+    };
+}
+
+#endif //GI_INLINECACHE_H
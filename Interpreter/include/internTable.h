@@ -0,0 +1,34 @@
+#ifndef GI_INTERNTABLE_H
+#define GI_INTERNTABLE_H
+
+#include <cstddef>
+#include <context.h>
+
+namespace context {
+    // Hash-consing of numbers and pairs. While enabled, numbers and pairs made by evaluation are
+    // canonical: structurally equal ones are the same object, so points of big scenes are shared
+    // and equal? compares them by address. A pair is canonical only if its car and cdr are
+    // canonical numbers or pairs, or nil/#t/#f. -0 and NaN aren't canonical: -0 = 0, and NaN isn't
+    // = to itself.
+    // The table refers to values weakly: a value leaves it once nothing else refers to it.
+    class InternTable {
+    public:
+        // Turned on by `--hash-cons`. Values made while it's off are kept as they are.
+        static bool enabled;
+
+        // Number n, canonical if enabled
+        static pExpr number(double n);
+
+        // Pair (car . cdr), canonical if enabled and car and cdr can be shared
+        static pExpr pair(const pExpr &car, const pExpr &cdr);
+
+        // Structural equality, as equal?: numbers by =, pairs and vectors by elements,
+        // anything else by identity. Two canonical values are equal iff they are the same.
+        static bool equal(const ast::ExprAST *a, const ast::ExprAST *b);
+
+        // Canonical values alive now
+        static std::size_t size();
+    };
+}
+
+#endif //GI_INTERNTABLE_H
@@ -26,6 +26,7 @@ namespace lexers {
             TokLambda = -12,
             TokNil = -13,
             TokCond = -14,
+            TokDefineMemo = -15,
         };
 
 
@@ -47,12 +48,24 @@ namespace lexers {
 
         TokenType stepForward();
 
+        // Line of current token. Each appended expression starts on a new line
+        int getLine() const { return line; }
+
+        // Name of the source, like filename, used in location of AST node
+        const std::string &getName() const { return name; }
+
+        void setName(const std::string &n) { name = n; }
+
+        // Line of the first token, for a part of a source that starts further in, see Reader
+        void setLine(int l) { line = l; }
+
     private:
 
         std::string processExp(const std::string exp) const;
 
         std::map<std::string, TokenType> keyWord = {
                 {"define", TokDefine},
+                {"define-memo", TokDefineMemo},
                 {"let",    TokLet},
                 {"if",     TokIf},
                 {"cond",   TokCond},
@@ -69,6 +82,9 @@ namespace lexers {
 
         std::stringstream expressionBuf;
         TokenType currentType = TokEOF;
+
+        int line = 0;
+        std::string name = "<input>";
     };
 }
 #endif //GI_LEXERS_H
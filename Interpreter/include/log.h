@@ -0,0 +1,23 @@
+#ifndef GI_LOG_H
+#define GI_LOG_H
+
+#include <easylogging++.h>
+
+// Lowest log level compiled into binary, set by CMake option LSI_LOG_LEVEL
+#define LSI_LOG_LEVEL_DEBUG 0
+#define LSI_LOG_LEVEL_INFO 1
+#define LSI_LOG_LEVEL_NONE 2
+
+#ifndef LSI_LOG_LEVEL
+#define LSI_LOG_LEVEL LSI_LOG_LEVEL_DEBUG
+#endif
+
+// Use DEBUG_LOG instead of CLOG(DEBUG, ...) on hot paths: when it's compiled out,
+// the streamed operands are still type checked but never evaluated, so no string is built.
+#if LSI_LOG_LEVEL <= LSI_LOG_LEVEL_DEBUG
+#define DEBUG_LOG(logger) CLOG(DEBUG, logger)
+#else
+#define DEBUG_LOG(logger) if (true) {} else CLOG(DEBUG, logger)
+#endif
+
+#endif //GI_LOG_H
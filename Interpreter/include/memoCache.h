@@ -0,0 +1,62 @@
+#ifndef GI_MEMOCACHE_H
+#define GI_MEMOCACHE_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <context.h>
+
+namespace context {
+    // Results of a memoized function, see ast::MemoizedAST. Calls are told apart by the structure
+    // of their arguments: numbers, booleans, nil and lists of them. A call with anything else,
+    // e.g. a vector, which may change, or a function, isn't cached.
+    // Least recently used results are dropped beyond capacity. Locked, since a function defined
+    // by the standard library is shared by parallel renders.
+    class MemoCache {
+    public:
+        explicit MemoCache(std::size_t capacity = DEFAULT_CAPACITY) : capacity{capacity} {}
+
+        MemoCache(const MemoCache &) = delete;
+
+        MemoCache &operator=(const MemoCache &) = delete;
+
+        // Whether a call with args can be cached; if so, hash is set to what find and insert take
+        static bool key(const std::vector<pExpr> &args, std::size_t &hash);
+
+        // Result of a call with args, nullptr if not cached. Counts a hit or a miss.
+        pExpr find(const std::vector<pExpr> &args, std::size_t hash);
+
+        // Keep result of a call with args, if it is made of the same kinds of values as a key;
+        // a vector may change later, and a closure may depend on the scope it was made in
+        void insert(const std::vector<pExpr> &args, std::size_t hash, const pExpr &result);
+
+        // Counts a call that can't be cached as a miss
+        void uncached();
+
+        std::size_t hits() const;
+
+        std::size_t misses() const;
+
+        std::size_t size() const;
+
+        static const std::size_t DEFAULT_CAPACITY = 1024;
+
+    private:
+        struct Entry {
+            std::size_t hash;
+            std::vector<pExpr> args;
+            pExpr result;
+        };
+
+        const std::size_t capacity;
+        // Most recently used first
+        std::list<Entry> entries;
+        std::unordered_multimap<std::size_t, std::list<Entry>::iterator> index;
+        std::size_t hitCount = 0, missCount = 0;
+        mutable std::mutex mutex;
+    };
+}
+
+#endif //GI_MEMOCACHE_H
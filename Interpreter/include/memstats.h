@@ -0,0 +1,63 @@
+#ifndef GI_MEMSTATS_H
+#define GI_MEMSTATS_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+namespace profiler {
+    // Object counters per AST node type (and Scope), see Counted
+    class MemoryStats {
+    public:
+        struct Entry {
+            std::string name;
+            std::atomic<long> created{0}, live{0}, peak{0};
+
+            void add();
+
+            void remove();
+        };
+
+        // Turned on by `--mem-stats`. Turn it on before objects are created, otherwise
+        // objects created while it's off are not counted but their destruction may be.
+        static bool enabled;
+
+        static Entry *registerType(const std::type_info &);
+
+        // Objects alive now, and highest number of objects alive at the same time
+        static long live();
+
+        static long peak();
+
+        // Report sorted by created objects
+        static void report(std::ostream &);
+
+        // Clear created counters and start peak from current live objects
+        static void reset();
+    };
+
+    // Base of a counted class T: `class PairAST : public ExprAST, private Counted<PairAST>`.
+    // It's empty, so it doesn't enlarge T; when MemoryStats is off it costs a branch per construction.
+    template<class T>
+    class Counted {
+    protected:
+        Counted() {
+            if (MemoryStats::enabled) entry->add();
+        }
+
+        Counted(const Counted &) : Counted() {}
+
+        ~Counted() {
+            if (MemoryStats::enabled) entry->remove();
+        }
+
+    private:
+        static MemoryStats::Entry *const entry;
+    };
+
+    template<class T>
+    MemoryStats::Entry *const Counted<T>::entry = MemoryStats::registerType(typeid(T));
+}
+
+#endif //GI_MEMSTATS_H
@@ -0,0 +1,50 @@
+#ifndef GI_OPTIMIZER_H
+#define GI_OPTIMIZER_H
+
+#include <AST.h>
+#include <visitor.h>
+
+namespace visitor {
+    // Optimization pass between parsing and evaluation:
+    // 1. fold pure builtin calls on literal arguments, e.g. (* 2 (+ 1 0.5)) => 3
+    // 2. prune if/cond branches on constant condition, e.g. (cond (#t a) (else b)) => a
+    // 3. do car, cdr, cons, + and * in place of calling them, see ast::InlineBuiltinAST
+    // Builtins can't be rebound (Scope::findSymbol looks them up first),
+    // so folding and inlining them is always safe.
+    // Original tree is never changed; unchanged subtrees are shared with the result.
+    class OptimizeVisitor : public NodeVisitor {
+    public:
+        ast::pExpr optimize(const ast::pExpr &);
+
+        // Turned off by `--no-opt` to debug the evaluator on original tree
+        static bool enabled;
+
+        void visitAllExprAST(const ast::AllExprAST &) override;
+
+        void visitIdentifierAST(const ast::IdentifierAST &) override;
+
+        void visitIfStatementAST(const ast::IfStatementAST &) override;
+
+        void visitCondStatementAST(const ast::CondStatementAST &) override;
+
+        void visitLetStatementAST(const ast::LetStatementAST &) override;
+
+        void visitValueBindingAST(const ast::ValueBindingAST &) override;
+
+        void visitLambdaAST(const ast::LambdaAST &) override;
+
+        void visitLambdaBindingAST(const ast::LambdaBindingAST &) override;
+
+        void visitLambdaApplicationAST(const ast::InvocationAST &) override;
+
+    private:
+        bool optimizeAll(const std::vector<ast::pExpr> &, std::vector<ast::pExpr> &);
+
+        ast::pExpr result;
+    };
+
+    // Optimize the tree if optimization is enabled, otherwise return it as is
+    ast::pExpr optimize(const ast::pExpr &);
+}
+
+#endif //GI_OPTIMIZER_H
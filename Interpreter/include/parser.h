@@ -12,6 +12,10 @@ namespace parser {
 
     std::shared_ptr<ExprAST> parseAllExpr(lexers::Lexer &lex);
 
+    // Split source at top-level forms and parse them with `jobs` threads. Result is in source order.
+    // name is that of the source, as in locations of lambdas parsed serially, see Lexer::setName.
+    std::shared_ptr<ExprAST> parseAllExpr(const std::string &src, unsigned jobs, const std::string &name = "<input>");
+
     std::shared_ptr<ExprAST> parseRawExpr(lexers::Lexer &lex);
 
     std::shared_ptr<ExprAST> parseBracketExpr(lexers::Lexer &lex);
@@ -45,5 +49,8 @@ namespace parser {
     std::shared_ptr<ExprAST> parseLambdaDefinitionExpr(lexers::Lexer &lex);
 
     std::shared_ptr<ExprAST> parseFunctionDefinitionExpr(lexers::Lexer &lex);
+
+    // (define-memo (f args...) body...) is (define f (#memoize (lambda (args...) body...)))
+    std::shared_ptr<ExprAST> parseMemoDefinitionExpr(lexers::Lexer &lex);
 }
 #endif //GI_PARSER_H
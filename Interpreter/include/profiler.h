@@ -0,0 +1,54 @@
+#ifndef GI_PROFILER_H
+#define GI_PROFILER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace profiler {
+    // Number of `operator new` calls made by current thread so far, see AllocationCounting
+    std::size_t allocationCount();
+
+    // Bytes allocated minus bytes freed by current thread so far, see AllocationCounting.
+    // Memory freed by another thread than its allocator makes it drift, so only use differences.
+    long long heapBalance();
+
+    // Allocations are only counted while an AllocationCounting that is on is alive, in any thread,
+    // so that operator new and delete are plain malloc and free otherwise
+    class AllocationCounting {
+    public:
+        explicit AllocationCounting(bool on = true);
+
+        AllocationCounting(const AllocationCounting &) = delete;
+
+        AllocationCounting &operator=(const AllocationCounting &) = delete;
+
+        ~AllocationCounting();
+
+    private:
+        bool on;
+    };
+
+    // Per-function profiler driven by Scope::stepIntoFunc/stepOutFunc.
+    // Unlike Scope::callTrace, it's global state and expects evaluation in a single thread.
+    // Self time/allocations exclude callees; total ones include them, counting recursive calls once.
+    class Profiler {
+    public:
+        // Turned on by `--profile`; enter/leave are not called at all if it's off
+        static bool enabled;
+
+        static void enter(const std::string &name);
+
+        static void leave();
+
+        static void reset();
+
+        // Flat report, sorted by self time
+        static void report(std::ostream &);
+
+        // One `caller;callee <self microseconds>` line per call path, input of flamegraph.pl
+        static void collapsedStacks(std::ostream &);
+    };
+}
+
+#endif //GI_PROFILER_H
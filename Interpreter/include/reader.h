@@ -0,0 +1,67 @@
+#ifndef GI_READER_H
+#define GI_READER_H
+
+#include <deque>
+#include <string>
+#include <AST.h>
+
+namespace parser {
+    using namespace ast;
+
+    // Incremental reader for REPL-like input.
+    // It splits the input into top-level forms as text arrives, so each form is lexed and parsed
+    // exactly once, no matter how long the session is. Like Lexer::appendExp, each appended chunk
+    // ends with an implicit line feed: it terminates pending atoms and comments.
+    class Reader {
+    public:
+        Reader() {}
+
+        explicit Reader(const std::string &exp) {
+            appendExp(exp);
+        }
+
+        // Throw MissBracket on unbalanced ')', and all buffered input is dropped.
+        Reader &appendExp(const std::string &exp);
+
+        // Whether at least one complete top-level form is buffered.
+        bool ready() const { return !forms.empty(); }
+
+        // Number of brackets still open in the pending (incomplete) form.
+        int depth() const { return bracketDepth; }
+
+        // Number of complete top-level forms buffered.
+        size_t size() const { return forms.size(); }
+
+        // Source text of the complete top-level forms; consumes them. If lines is given, it gets the
+        // line each form starts on, for Lexer::setLine of the lexer reading the form.
+        std::deque<std::string> takeForms(std::deque<int> *lines = nullptr);
+
+        // Parse the complete top-level forms into an AllExprAST and consume them.
+        // The pending form, if any, is kept for following appendExp.
+        std::shared_ptr<ExprAST> parseReady();
+
+        void clear();
+
+    private:
+        enum State {
+            Blank,
+            Atom,
+            Hash,
+            Comment,
+        };
+
+        void scan(char c);
+
+        void finishForm();
+
+        std::deque<std::string> forms;
+        std::deque<int> formLines;
+        std::string pending;
+        // Line of the character being scanned, and the one pending form starts on
+        int line = 0, pendingLine = 0;
+        int bracketDepth = 0;
+        State state = Blank;
+    };
+}
+
+#endif //GI_READER_H
@@ -0,0 +1,56 @@
+#ifndef GI_TRACER_H
+#define GI_TRACER_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+
+namespace profiler {
+    // Collects Chrome trace events ("Trace Event Format", readable by chrome://tracing and Perfetto).
+    // Unlike Profiler, it's meant for coarse phases (parsing, loading, drawing), and is thread safe.
+    class Tracer {
+    public:
+        // Turned on by `--trace`; TraceScope costs a single branch if it's off
+        static bool enabled;
+
+        // Events shorter than threshold are dropped, so frequent short phases don't flood the trace
+        static std::chrono::microseconds threshold;
+
+        static void record(const char *category, const std::string &name, const std::string &detail,
+                           std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::duration dur);
+
+        static void clear();
+
+        // Number of recorded events
+        static std::size_t size();
+
+        // Write all recorded events as a JSON object
+        static void write(std::ostream &);
+    };
+
+    // Record the lifetime of this object as a complete event
+    class TraceScope {
+    public:
+        TraceScope(const char *category, const std::string &name);
+
+        TraceScope(const TraceScope &) = delete;
+
+        TraceScope &operator=(const TraceScope &) = delete;
+
+        ~TraceScope();
+
+        // Whether this event will be kept if it ends now. Use it to skip building costly details.
+        bool sampled() const;
+
+        // Extra information shown in `args` of the event
+        void setDetail(const std::string &detail) { if (active) this->detail = detail; }
+
+    private:
+        bool active;
+        const char *category;
+        std::string name, detail;
+        std::chrono::steady_clock::time_point begin;
+    };
+}
+
+#endif //GI_TRACER_H
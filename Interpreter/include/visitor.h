@@ -2,6 +2,7 @@
 #define GI_VISITOR_H
 
 #include <string>
+#include <vector>
 #include <AST.h>
 #include <builtinAST.h>
 
@@ -32,6 +33,10 @@ namespace visitor {
 
         virtual void visitNilAST(const ast::NilAST &) {}
 
+        virtual void visitVectorAST(const ast::VectorAST &) {}
+
+        virtual void visitRestArgsAST(const ast::RestArgsAST &) {}
+
         virtual void visitBindingAST(const ast::BindingAST &) {}
 
         virtual void visitValueBindingAST(const ast::ValueBindingAST &) {}
@@ -58,6 +63,44 @@ namespace visitor {
 
         virtual void visitBuiltinReciprocalAST(const ast::BuiltinReciprocalAST &) {}
 
+        virtual void visitBuiltinMemStatsAST(const ast::BuiltinMemStatsAST &) {}
+
+        virtual void visitBuiltinMapAST(const ast::BuiltinMapAST &) {}
+
+        virtual void visitBuiltinAppendAST(const ast::BuiltinAppendAST &) {}
+
+        virtual void visitBuiltinReverseAST(const ast::BuiltinReverseAST &) {}
+
+        virtual void visitBuiltinLengthAST(const ast::BuiltinLengthAST &) {}
+
+        virtual void visitBuiltinReduceAST(const ast::BuiltinReduceAST &) {}
+
+        virtual void visitBuiltinFilterAST(const ast::BuiltinFilterAST &) {}
+
+        virtual void visitBuiltinMakeVectorAST(const ast::BuiltinMakeVectorAST &) {}
+
+        virtual void visitBuiltinVectorAST(const ast::BuiltinVectorAST &) {}
+
+        virtual void visitBuiltinVectorRefAST(const ast::BuiltinVectorRefAST &) {}
+
+        virtual void visitBuiltinVectorSetAST(const ast::BuiltinVectorSetAST &) {}
+
+        virtual void visitBuiltinVectorLengthAST(const ast::BuiltinVectorLengthAST &) {}
+
+        virtual void visitBuiltinVectorMapAST(const ast::BuiltinVectorMapAST &) {}
+
+        virtual void visitBuiltinVectorToListAST(const ast::BuiltinVectorToListAST &) {}
+
+        virtual void visitBuiltinListToVectorAST(const ast::BuiltinListToVectorAST &) {}
+
+        virtual void visitBuiltinEqualAST(const ast::BuiltinEqualAST &) {}
+
+        virtual void visitMemoizedAST(const ast::MemoizedAST &) {}
+
+        virtual void visitBuiltinMemoizeAST(const ast::BuiltinMemoizeAST &) {}
+
+        virtual void visitBuiltinMemoStatsAST(const ast::BuiltinMemoStatsAST &) {}
+
         virtual void visitLambdaBindingAST(const ast::LambdaBindingAST &) {}
 
         virtual void visitLambdaApplicationAST(const ast::InvocationAST &) {}
@@ -77,14 +120,22 @@ namespace visitor {
 
         void visitNilAST(const ast::NilAST &) override;
 
+        void visitVectorAST(const ast::VectorAST &) override;
+
+        void visitRestArgsAST(const ast::RestArgsAST &) override;
+
         void visitLambdaAST(const ast::LambdaAST &) override;
 
+        void visitMemoizedAST(const ast::MemoizedAST &) override;
+
         std::string to_string() const;
 
         void clear();
 
     private:
         std::string prettyPrint;
+        // Elements of the vectors being printed, outermost first
+        std::vector<const std::vector<ast::pExpr> *> printing;
     };
 }
 
@@ -0,0 +1,43 @@
+#include <algorithm>
+#include <cstdint>
+#include <arena.h>
+
+using namespace parser;
+
+namespace {
+    const std::size_t MAX_BLOCK_SIZE = 8 * 1024 * 1024;
+
+    thread_local std::shared_ptr<Arena> currentArena;
+}
+
+void *Arena::allocate(std::size_t size, std::size_t align) {
+    auto addr = (reinterpret_cast<std::uintptr_t>(cur) + align - 1) & ~(align - 1);
+    if (!cur || addr + size > reinterpret_cast<std::uintptr_t>(end)) {
+        newBlock(size + align);
+        addr = (reinterpret_cast<std::uintptr_t>(cur) + align - 1) & ~(align - 1);
+    }
+    cur = reinterpret_cast<char *>(addr + size);
+    allocated += size;
+    return reinterpret_cast<void *>(addr);
+}
+
+void Arena::newBlock(std::size_t size) {
+    // Grow geometrically, so a large file needs only a few blocks
+    auto blockSize = std::max(size, nextBlockSize);
+    nextBlockSize = std::min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+    blocks.emplace_back(new char[blockSize]);
+    cur = blocks.back().get();
+    end = cur + blockSize;
+}
+
+const std::shared_ptr<Arena> &Arena::current() {
+    return currentArena;
+}
+
+ArenaScope::ArenaScope() : owner{!currentArena} {
+    if (owner) currentArena = std::make_shared<Arena>();
+}
+
+ArenaScope::~ArenaScope() {
+    if (owner) currentArena.reset();
+}
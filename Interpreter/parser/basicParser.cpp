@@ -2,14 +2,21 @@
 #include <fstream>
 #include <lexers.h>
 #include <parser.h>
+#include <arena.h>
+#include <tracer.h>
 #include <exception.h>
 
 using namespace lexers;
 using namespace exception;
 using namespace parser;
+using namespace profiler;
 using namespace std;
 
 std::shared_ptr<ExprAST> parser::parseAllExpr(lexers::Lexer &lex) {
+    TraceScope trace{"parse", "parse"};
+    trace.setDetail(lex.getName());
+    // All nodes of this parse unit come from one arena
+    ArenaScope unit;
     vector<shared_ptr<ExprAST>> vec;
     while (lex.getTokType() != Lexer::TokEOF)
         vec.push_back(parseExpr(lex));
@@ -53,6 +60,9 @@ std::shared_ptr<ExprAST> parser::parseBracketExpr(lexers::Lexer &lex) {
         case Lexer::TokDefine:
             res = parseDefinitionExpr(lex);
             break;
+        case Lexer::TokDefineMemo:
+            res = parseMemoDefinitionExpr(lex);
+            break;
         case Lexer::TokIf:
             res = parseIfStatementExpr(lex);
             break;
@@ -82,18 +92,18 @@ std::shared_ptr<ExprAST> parser::parseBracketExpr(lexers::Lexer &lex) {
 
 shared_ptr<ExprAST> parser::parseNumberExpr(Lexer &lex) {
     auto num = lex.getNum();
-    return make_shared<NumberAST>(num);
+    return makeNode<NumberAST>(num);
 }
 
 shared_ptr<ExprAST> parser::parseIdentifierExpr(lexers::Lexer &lex) {
     auto str = lex.getIdentifier();
-    return make_shared<IdentifierAST>(str);
+    return makeNode<IdentifierAST>(str);
 }
 
 
 shared_ptr<ExprAST> parser::parseIdDefinitionExpr(lexers::Lexer &lex) {
     auto identifier = lex.getIdentifier();
-    return make_shared<ValueBindingAST>(identifier, parseExpr(lex));
+    return makeNode<ValueBindingAST>(identifier, parseExpr(lex));
 }
 
 
@@ -3,6 +3,7 @@
 #include <lexers.h>
 #include <exception.h>
 #include <parser.h>
+#include <arena.h>
 
 using namespace lexers;
 using namespace exception;
@@ -15,7 +16,7 @@ shared_ptr<ExprAST> parser::parseFunctionApplicationExpr(lexers::Lexer &lex) {
     while (lex.getTokType() != Lexer::TokClosingBracket) {
         arguments.push_back(parseExpr(lex));
     }
-    return make_shared<InvocationAST>(make_shared<IdentifierAST>(identifier), arguments);
+    return makeNode<InvocationAST>(makeNode<IdentifierAST>(identifier), arguments);
 }
 
 shared_ptr<ExprAST> parser::parseLambdaApplicationExpr(lexers::Lexer &lex) {
@@ -24,10 +25,11 @@ shared_ptr<ExprAST> parser::parseLambdaApplicationExpr(lexers::Lexer &lex) {
     while (lex.getTokType() != Lexer::TokClosingBracket) {
         arguments.push_back(parseExpr(lex));
     }
-    return make_shared<InvocationAST>(lambda, arguments);
+    return makeNode<InvocationAST>(lambda, arguments);
 }
 
 std::shared_ptr<ExprAST> parser::parseLambdaDefinitionExpr(lexers::Lexer &lex) {
+    auto location = lex.getName() + ":" + to_string(lex.getLine());
     if (lex.stepForward() != Lexer::TokOpeningBracket || lex.stepForward() != Lexer::TokIdentifier) {
         throw UnsupportedSyntax("Lambda definition needs argument(s)");
     }
@@ -46,7 +48,7 @@ std::shared_ptr<ExprAST> parser::parseLambdaDefinitionExpr(lexers::Lexer &lex) {
     while (lex.getTokType() != Lexer::TokClosingBracket) {
         expression.push_back(parseExpr(lex));
     }
-    return make_shared<LambdaAST>(args, expression);
+    return makeNode<LambdaAST>(args, expression, location);
 }
 
 shared_ptr<ExprAST> parser::parseFunctionDefinitionExpr(lexers::Lexer &lex) {
@@ -70,6 +72,33 @@ shared_ptr<ExprAST> parser::parseFunctionDefinitionExpr(lexers::Lexer &lex) {
     while (lex.getTokType() != Lexer::TokClosingBracket) {
         expression.push_back(parseExpr(lex));
     }
-    return make_shared<LambdaBindingAST>(identifier, args, expression);
+    return makeNode<LambdaBindingAST>(identifier, args, expression);
 }
 
+
+shared_ptr<ExprAST> parser::parseMemoDefinitionExpr(lexers::Lexer &lex) {
+    auto location = lex.getName() + ":" + to_string(lex.getLine());
+    if (lex.stepForward() != Lexer::TokOpeningBracket || lex.stepForward() != Lexer::TokIdentifier) {
+        throw UnsupportedSyntax("Memoized function definition needs a name");
+    }
+
+    auto identifier = lex.getIdentifier();
+    vector<string> args;
+    while (lex.getTokType() == Lexer::TokIdentifier) {
+        args.push_back(lex.getIdentifier());
+    }
+
+    if (lex.getTokType() != Lexer::TokClosingBracket) {
+        throw MissBracket("Memoized function definition need ) to end argument declaration");
+    } else {
+        lex.stepForward();
+    }
+
+    std::vector<std::shared_ptr<ExprAST>> expression;
+    while (lex.getTokType() != Lexer::TokClosingBracket) {
+        expression.push_back(parseExpr(lex));
+    }
+    vector<shared_ptr<ExprAST>> memoizeArgs{makeNode<LambdaAST>(args, expression, location)};
+    return makeNode<ValueBindingAST>(identifier,
+                                     makeNode<InvocationAST>(makeNode<IdentifierAST>("#memoize"), memoizeArgs));
+}
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <lexers.h>
 #include <parser.h>
+#include <arena.h>
 #include <exception.h>
 
 using namespace lexers;
@@ -27,7 +28,7 @@ std::shared_ptr<ExprAST> parser::parseIfStatementExpr(lexers::Lexer &lex) {
         auto condition = parseExpr(lex);
         auto trueClause = parseExpr(lex);
         auto falseClause = parseExpr(lex);
-        return make_shared<IfStatementAST>(condition, trueClause, falseClause);
+        return makeNode<IfStatementAST>(condition, trueClause, falseClause);
     } catch (RuntimeError &e) {
         throw NotAtomType(std::string(e.what()) + " @ if statement");
     }
@@ -35,7 +36,7 @@ std::shared_ptr<ExprAST> parser::parseIfStatementExpr(lexers::Lexer &lex) {
 
 std::shared_ptr<ExprAST> parser::parseTrueExpr(lexers::Lexer &lex) {
     lex.stepForward();
-    return make_shared<BooleansTrueAST>();
+    return makeNode<BooleansTrueAST>();
 }
 
 std::shared_ptr<ExprAST> parser::parseCondStatementExpr(lexers::Lexer &lex) {
@@ -47,24 +48,24 @@ std::shared_ptr<ExprAST> parser::parseCondStatementExpr(lexers::Lexer &lex) {
         result.push_back(parseExpr(lex));
         lex.stepForward();
     }
-    return make_shared<CondStatementAST>(condition, result);
+    return makeNode<CondStatementAST>(condition, result);
 }
 
 std::shared_ptr<ExprAST> parser::parseFalseExpr(lexers::Lexer &lex) {
     lex.stepForward();
-    return make_shared<BooleansFalseAST>();
+    return makeNode<BooleansFalseAST>();
 }
 
 std::shared_ptr<ExprAST> parser::parseLoadingFileExpr(lexers::Lexer &lex) {
     lex.stepForward();
     auto filename = lex.getIdentifier().substr(1);
     filename.pop_back();
-    return make_shared<LoadingFileAST>(filename);
+    return makeNode<LoadingFileAST>(filename);
 }
 
 std::shared_ptr<ExprAST> parser::parseNilExpr(lexers::Lexer &lex) {
     lex.stepForward();
-    return std::make_shared<NilAST>();
+    return makeNode<NilAST>();
 }
 
 std::shared_ptr<ExprAST> parser::parseLetStatementExpr(lexers::Lexer &lex) {
@@ -79,6 +80,6 @@ std::shared_ptr<ExprAST> parser::parseLetStatementExpr(lexers::Lexer &lex) {
     }
     lex.stepForward();
     std::shared_ptr<ExprAST> expr = parseExpr(lex);
-    return make_shared<LetStatementAST>(id, v, expr);
+    return makeNode<LetStatementAST>(id, v, expr);
 }
 
@@ -41,7 +41,7 @@ Lexer::TokenType Lexer::stepForward() {
     if (type == EOF) {
         currentType = TokEOF;
     } else if (isspace(type)) {
-        expressionBuf.get();
+        if (expressionBuf.get() == '\n') line++;
         return stepForward();
     } else if (isdigit(type)) {
         expressionBuf >> numToken;
@@ -66,6 +66,7 @@ Lexer::TokenType Lexer::stepForward() {
             do {
                 type = expressionBuf.get();
             } while (type != EOF && type != '\n');
+            if (type == '\n') line++;
             return stepForward();
         }
     }
@@ -88,6 +89,7 @@ std::string Lexer::processExp(const std::string exp) const {
 }
 
 void Lexer::clear() {
+    line = 0;
     expressionBuf.str("");
     if (currentType == TokEOF) expressionBuf.clear();
     currentType = TokEOF;
@@ -0,0 +1,84 @@
+#include <memory>
+#include <thread>
+#include <exception>
+#include <lexers.h>
+#include <parser.h>
+#include <reader.h>
+#include <arena.h>
+#include <tracer.h>
+#include <exception.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace profiler;
+using namespace std;
+
+namespace {
+    // Too small chunk costs more on thread creation than parsing
+    const size_t MIN_CHUNK_SIZE = 16 * 1024;
+
+    void parseChunk(const deque<string> &forms, const deque<int> &lines, const string &name, size_t beg, size_t end,
+                    vector<shared_ptr<ExprAST>> &res, exception_ptr &error) {
+        try {
+            TraceScope trace{"parse", "parse chunk"};
+            // Each worker owns the arena of its chunk
+            ArenaScope unit;
+            for (size_t i = beg; i < end; i++) {
+                Lexer lex;
+                lex.setName(name);
+                lex.setLine(lines[i]);
+                lex.appendExp(forms[i]);
+                while (lex.getTokType() != Lexer::TokEOF)
+                    res.push_back(parseExpr(lex));
+            }
+            if (trace.sampled()) trace.setDetail("forms " + to_string(beg) + "-" + to_string(end));
+        } catch (...) {
+            error = current_exception();
+        }
+    }
+}
+
+std::shared_ptr<ExprAST> parser::parseAllExpr(const std::string &src, unsigned jobs, const std::string &name) {
+    TraceScope trace{"parse", "parse"};
+    deque<string> forms;
+    deque<int> lines;
+    {
+        TraceScope read{"parse", "read"};
+        // The reader only counts brackets and comments, which is much faster than lexing
+        Reader reader{src};
+        if (reader.depth() != 0) throw exception::MissBracket("Bracket doesn't match");
+        forms = reader.takeForms(&lines);
+    }
+
+    jobs = static_cast<unsigned>(max<size_t>(1, min<size_t>(jobs, src.size() / MIN_CHUNK_SIZE)));
+
+    // Split forms into `jobs` contiguous chunks with nearly equal text size
+    vector<size_t> bound{0};
+    size_t acc = 0;
+    for (size_t i = 0; i < forms.size(); i++) {
+        acc += forms[i].size();
+        if (acc * jobs >= src.size() * bound.size() && bound.size() < jobs) bound.push_back(i + 1);
+    }
+    bound.push_back(forms.size());
+
+    auto chunks = bound.size() - 1;
+    vector<vector<shared_ptr<ExprAST>>> res(chunks);
+    vector<exception_ptr> errors(chunks);
+    vector<thread> workers;
+    for (size_t i = 1; i < chunks; i++)
+        workers.emplace_back(parseChunk, cref(forms), cref(lines), cref(name), bound[i], bound[i + 1],
+                             ref(res[i]), ref(errors[i]));
+    // current thread takes the first chunk
+    parseChunk(forms, lines, name, bound[0], bound[1], res[0], errors[0]);
+    for (auto &worker: workers) worker.join();
+    if (trace.sampled()) trace.setDetail(to_string(forms.size()) + " forms in " + to_string(chunks) + " chunk(s)");
+
+    // Report the error which appears first in source
+    for (auto &error: errors)
+        if (error) rethrow_exception(error);
+
+    vector<shared_ptr<ExprAST>> vec;
+    for (auto &chunk: res)
+        vec.insert(end(vec), begin(chunk), end(chunk));
+    return make_shared<AllExprAST>(vec);
+}
@@ -0,0 +1,105 @@
+#include <memory>
+#include <lexers.h>
+#include <parser.h>
+#include <reader.h>
+#include <arena.h>
+#include <exception.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace exception;
+using namespace std;
+
+Reader &Reader::appendExp(const std::string &exp) {
+    for (char c: exp) scan(c);
+    // Same as Lexer::appendExp: chunks are separated by line feed
+    scan('\n');
+    return *this;
+}
+
+void Reader::scan(char c) {
+    // A form starts with the first character kept after an empty pending form
+    if (pending.empty()) pendingLine = line;
+    if (c == '\n') line++;
+
+    // '#' followed by a delimiter starts a comment, otherwise it is a part of atom like #t or #painter
+    if (state == Hash) {
+        if (isspace(c) || c == '(' || c == ')') {
+            pending.pop_back();
+            state = Comment;
+        } else {
+            state = Atom;
+            pending.push_back(c);
+            return;
+        }
+    }
+
+    if (state == Comment) {
+        if (c == '\n') state = Blank;
+        return;
+    }
+
+    if (c == '(') {
+        if (state == Atom && bracketDepth == 0) finishForm();
+        bracketDepth++;
+        state = Blank;
+        pending.push_back(c);
+    } else if (c == ')') {
+        if (bracketDepth == 0) {
+            clear();
+            throw MissBracket("Unexpected ) in top-level form");
+        }
+        bracketDepth--;
+        state = Blank;
+        pending.push_back(c);
+        if (bracketDepth == 0) finishForm();
+    } else if (isspace(c)) {
+        if (state == Atom && bracketDepth == 0) finishForm();
+        state = Blank;
+        if (!pending.empty()) pending.push_back(c);
+    } else if (c == '#' && state == Blank) {
+        state = Hash;
+        pending.push_back(c);
+    } else {
+        state = Atom;
+        pending.push_back(c);
+    }
+}
+
+void Reader::finishForm() {
+    formLines.push_back(pendingLine);
+    forms.push_back(std::move(pending));
+    pending.clear();
+}
+
+std::deque<std::string> Reader::takeForms(std::deque<int> *lines) {
+    std::deque<std::string> ret;
+    ret.swap(forms);
+    if (lines) lines->swap(formLines);
+    formLines.clear();
+    return ret;
+}
+
+std::shared_ptr<ExprAST> Reader::parseReady() {
+    ArenaScope unit;
+    vector<shared_ptr<ExprAST>> vec;
+    deque<int> lines;
+    auto ready = takeForms(&lines);
+    for (size_t i = 0; i < ready.size(); i++) {
+        Lexer lex;
+        lex.setLine(lines[i]);
+        lex.appendExp(ready[i]);
+        while (lex.getTokType() != Lexer::TokEOF)
+            vec.push_back(parseExpr(lex));
+    }
+    return make_shared<AllExprAST>(vec);
+}
+
+void Reader::clear() {
+    forms.clear();
+    formLines.clear();
+    line = 0;
+    pending.clear();
+    bracketDepth = 0;
+    state = Blank;
+}
@@ -1,31 +1,233 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <cxxopts.hpp>
 #include <parser.h>
-#include <exception.h>
+#include <context.h>
+#include <builtinAST.h>
+#include <visitor.h>
+#include <optimizer.h>
+#include <profiler.h>
+#include <embeddedLib.h>
+#include "regression.h"
 
 using namespace std;
+using namespace ast;
 using namespace lexers;
 using namespace parser;
-using namespace exception;
+using namespace context;
 
-int main() {
-    try {
+// Benchmark suite of the interpreter. Each workload runs in a forked process, so peak RSS
+// belongs to that workload only; results are printed as JSON. Run it in Release build.
+// With `--baseline`, results are compared with a previous run and regressions fail the process.
+
+namespace {
+    struct Workload {
+        string name;
+        // Evaluated once before timing, in a fresh scope with stdlib loaded
+        string setup;
+        // Evaluated `repeat` times, each one is timed
+        string body;
+    };
+
+    // Number of points drawn by #painter; nothing is rasterized, only the interpreter is measured
+    size_t points = 0;
+
+    class CountingDrawAST : public BuiltinDrawAST {
+    public:
+        APPLY_FUNC
+
+        pExpr getPointer() const override {
+            return make_shared<CountingDrawAST>(*this);
+        }
+    };
+
+    pExpr CountingDrawAST::apply(const vector<pExpr> &actualArgs, pScope &s) const {
+        auto exprPtr = actualArgs.front();
+        while (auto pairPtr = dynamic_pointer_cast<PairAST>(exprPtr)) {
+            points++;
+            exprPtr = pairPtr->data.second;
+        }
+        s->stepOutFunc();
+        return make_shared<CountingDrawAST>();
+    }
+
+    const string RANGE =
+        "(define (range n)"
+            "  (define (iter i res) (if (< i 0) res (iter (+ i -1) (cons i res))))"
+            "  (iter (+ n -1) nil))";
+
+    const vector<Workload> workloads = {
+        {"fib", "(define (fib n) (if (< n 2) n (+ (fib (+ n -1)) (fib (+ n -2)))))", "(fib 20)"},
+        {"tail-loop", "(define (loop n) (if (< n 1) 0 (loop (+ n -1))))", "(loop 100000)"},
+        // Base.scm's -, = and > (and `and` inside them) take rest arguments
+        {"variadic", "(define (count n acc) (if (= n 0) acc (count (- n 1) (if (> n acc) n acc))))",
+            "(count 5000 0)"},
+        {"list", RANGE, "(length (reverse (append (map (range 500) square) (range 500))))"},
+        {"line", "", "(length (line (cons 0 0) (cons 1000 700)))"},
+        {"circle", "", "(length (circle (cons 500 500) 150))"},
+        {"frame-painter", "",
+            "((beside (below line-painter (flip-vert line-painter))"
+                "         (below (rotate90 line-painter) (flip-horiz line-painter))) board)"},
+        {"painter3", "", "(load \"" LSI_SCHEME_DIR "/demo/painter3.scm\")"},
+    };
+
+    pScope createScope() {
         auto s = make_shared<Scope>();
-        lexers::Lexer lex;
-        lex.appendExp("(load \"setup.scm\")").appendExp("(load \"benchmark.scm\")");
-        lex.appendExp("#(length (l-painter default))");
-        lex.appendExp(
-                "(length ((beside (below painter (flip-vert painter)) (below painter (flip-vert painter))) default))");
-        auto ast = parseAllExpr(lex);
-        auto res = ast->eval(s, ast);
-        auto numPtr = std::dynamic_pointer_cast<NumberAST>(res);
-        if (numPtr) {
-            cout << numPtr->getValue() << endl;
-        } else {
-            cout << "ERROR" << endl;
+        s->addBuiltinFunc("#painter", make_shared<CountingDrawAST>());
+        Lexer lex;
+        for (const auto &lib : {"Base.scm", "Shape.scm", "Frame.scm"})
+            lex.appendExp(embedded::source(lib));
+        visitor::optimize(parseAllExpr(lex))->eval(s);
+        return s;
+    }
+
+    long peakRSS() {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+
+    // Run a workload in current process
+    benchmark::Result run(const Workload &w, unsigned repeat) {
+        auto s = createScope();
+        Lexer lex{w.setup};
+        visitor::optimize(parseAllExpr(lex))->eval(s);
+        lex.appendExp(w.body);
+        auto body = visitor::optimize(parseAllExpr(lex));
+
+        benchmark::Result result;
+        result.name = w.name;
+        profiler::AllocationCounting counting;
+        for (unsigned i = 0; i < repeat; i++) {
+            points = 0;
+            auto before = profiler::allocationCount();
+            auto beg = chrono::steady_clock::now();
+            auto res = body->eval(s);
+            chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - beg;
+            result.times.push_back(elapsed.count());
+            result.allocations = profiler::allocationCount() - before;
+            visitor::DisplayVisitor disp;
+            if (res) res->accept(disp);
+            result.result = disp.to_string();
         }
-    } catch (RuntimeError &e) {
-        CLOG(DEBUG, "exception") << e.what();
-        throw;
+        result.points = points;
+        result.peakRSS = peakRSS();
+        return result;
+    }
+
+    // Run a workload in a child process, so it starts from the same heap and has its own peak RSS
+    bool runForked(const Workload &w, unsigned repeat, benchmark::Result &result) {
+        int fd[2];
+        if (pipe(fd) != 0) return false;
+        cout.flush();
+        auto pid = fork();
+        if (pid == 0) {
+            close(fd[0]);
+            int status = 0;
+            try {
+                auto res = benchmark::toJson(run(w, repeat));
+                if (write(fd[1], res.data(), res.size()) != static_cast<ssize_t>(res.size())) status = 1;
+            } catch (std::exception &e) {
+                cerr << w.name << ": " << e.what() << endl;
+                status = 1;
+            }
+            close(fd[1]);
+            _exit(status);
+        }
+        close(fd[1]);
+        char buf[4096];
+        ssize_t n;
+        string json;
+        while ((n = read(fd[0], buf, sizeof buf)) > 0) json.append(buf, static_cast<size_t>(n));
+        close(fd[0]);
+        int status;
+        waitpid(pid, &status, 0);
+        if (pid <= 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return false;
+        result = benchmark::readResult(json);
+        return true;
+    }
+}
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char *argv[]) {
+    el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Enabled, "false");
+    cxxopts::Options options(argv[0], " - Benchmark of Scheme interpreter");
+    options.add_options()
+        ("f,filter", "Only run workloads whose name contains the string", cxxopts::value<string>())
+        ("r,repeat", "Repetitions of each workload (default 3)", cxxopts::value<unsigned>())
+        ("o,output", "Write JSON result to file instead of stdout", cxxopts::value<string>())
+        ("no-opt", "Do not optimize AST before evaluation")
+        ("b,baseline", "Compare with results in JSON file, exit with 2 if any workload regresses",
+         cxxopts::value<string>())
+        ("t,threshold", "Tolerated slowdown in percent when comparing with baseline (default 10)",
+         cxxopts::value<double>())
+        ("l,list", "List workloads")
+        ("h,help", "Print help");
+    options.parse(argc, argv);
+    if (options.count("help")) {
+        cout << options.help({""}) << endl;
+        return 0;
+    }
+    if (options.count("list")) {
+        for (const auto &w : workloads) cout << w.name << endl;
+        return 0;
+    }
+    visitor::OptimizeVisitor::enabled = !options.count("no-opt");
+    auto repeat = options.count("repeat") ? max(1u, options["repeat"].as<unsigned>()) : 3u;
+    auto filter = options.count("filter") ? options["filter"].as<string>() : "";
+    auto threshold = options.count("threshold") ? options["threshold"].as<double>() / 100 : 0.1;
+    vector<benchmark::Result> baseline;
+    if (options.count("baseline")) {
+        ifstream fin{options["baseline"].as<string>()};
+        if (!fin) {
+            cerr << "cannot open baseline " << options["baseline"].as<string>() << endl;
+            return 1;
+        }
+        try {
+            baseline = benchmark::readResults(fin);
+        } catch (std::runtime_error &e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+    }
+
+    vector<benchmark::Result> results;
+    bool failed = false;
+    for (const auto &w : workloads) {
+        if (w.name.find(filter) == string::npos) continue;
+        benchmark::Result result;
+        if (!runForked(w, repeat, result)) {
+            cerr << "workload " << w.name << " failed" << endl;
+            failed = true;
+            continue;
+        }
+        results.push_back(result);
+    }
+
+    ostringstream out;
+    out << "{\"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++)
+        out << (i ? ",\n  " : "\n  ") << benchmark::toJson(results[i]);
+    out << "\n]}\n";
+
+    if (options.count("output")) {
+        ofstream fout{options["output"].as<string>()};
+        fout << out.str();
+    } else {
+        cout << out.str();
     }
+    if (failed) return 1;
+    if (options.count("baseline") && benchmark::compare(baseline, results, threshold, cerr) > 0) return 2;
     return 0;
 }
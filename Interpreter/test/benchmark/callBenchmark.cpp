@@ -0,0 +1,52 @@
+#include <chrono>
+#include <iostream>
+#include <parser.h>
+#include <context.h>
+#include <profiler.h>
+#include <log.h>
+
+using namespace std;
+using namespace lexers;
+using namespace parser;
+
+// Cost of function calls, which is dominated by bookkeeping in Scope::stepIntoFunc/stepOutFunc.
+// Build with -DLSI_LOG_LEVEL=DEBUG and INFO to compare per-call logging compiled in and out.
+
+namespace {
+    const int REPEAT = 5;
+
+    void run(const string &name, const string &exp, shared_ptr<Scope> &s) {
+        Lexer lex{exp};
+        auto ast = parseAllExpr(lex);
+        double best = 0;
+        size_t allocs = 0;
+        profiler::AllocationCounting counting;
+        for (int i = 0; i < REPEAT; i++) {
+            auto before = profiler::allocationCount();
+            auto beg = chrono::steady_clock::now();
+            ast->eval(s);
+            chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - beg;
+            if (i == 0 || elapsed.count() < best) best = elapsed.count();
+            allocs = profiler::allocationCount() - before;
+        }
+        cout << name << "\t" << best << " ms\t" << allocs << " allocs" << endl;
+    }
+}
+
+INITIALIZE_EASYLOGGINGPP
+
+int main() {
+    el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Enabled, "false");
+    auto s = make_shared<Scope>();
+    Lexer lex{"(define (fib n) (if (< n 2) n (+ (fib (+ n -1)) (fib (+ n -2)))))"
+                  "(define (loop n) (if (< n 1) 0 (loop (+ n -1))))"
+                  "(define (anonymous n) (if (< n 1) 0 ((lambda (x) (anonymous x)) (+ n -1))))"};
+    parseAllExpr(lex)->eval(s);
+
+    cout << "log level\t" << (LSI_LOG_LEVEL <= LSI_LOG_LEVEL_DEBUG ? "DEBUG" : "INFO") << endl;
+    // 28656 calls of fib, each calls `<` and `+` as well
+    run("fib 20", "(fib 20)", s);
+    run("tail loop 100000", "(loop 100000)", s);
+    run("anonymous 2000", "(anonymous 2000)", s);
+    return 0;
+}
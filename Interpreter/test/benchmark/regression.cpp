@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "regression.h"
+
+using namespace std;
+using namespace benchmark;
+
+namespace {
+    // Just enough JSON to read our own output back
+    struct Value {
+        enum Type {
+            Null, Number, String, Array, Object
+        } type = Null;
+        double number = 0;
+        string str;
+        vector<Value> array;
+        map<string, Value> object;
+
+        const Value &operator[](const string &key) const {
+            static const Value null;
+            auto iter = object.find(key);
+            return iter == object.end() ? null : iter->second;
+        }
+    };
+
+    class Reader {
+    public:
+        explicit Reader(const string &s) : str(s) {}
+
+        Value parse() {
+            auto v = value();
+            skip();
+            if (pos != str.size()) error("trailing characters");
+            return v;
+        }
+
+    private:
+        void error(const string &msg) {
+            throw runtime_error("Malformed benchmark JSON at " + to_string(pos) + ": " + msg);
+        }
+
+        void skip() {
+            while (pos < str.size() && isspace(static_cast<unsigned char>(str[pos]))) pos++;
+        }
+
+        void expect(char c) {
+            skip();
+            if (pos >= str.size() || str[pos] != c) error(string("expect ") + c);
+            pos++;
+        }
+
+        Value value() {
+            skip();
+            if (pos >= str.size()) error("unexpected end");
+            Value v;
+            auto c = str[pos];
+            if (c == '{') {
+                v.type = Value::Object;
+                pos++;
+                skip();
+                if (pos < str.size() && str[pos] == '}') return pos++, v;
+                do {
+                    skip();
+                    auto key = string_();
+                    expect(':');
+                    v.object[key] = value();
+                    skip();
+                } while (pos < str.size() && str[pos++] == ',');
+                if (str[pos - 1] != '}') error("expect }");
+            } else if (c == '[') {
+                v.type = Value::Array;
+                pos++;
+                skip();
+                if (pos < str.size() && str[pos] == ']') return pos++, v;
+                do {
+                    v.array.push_back(value());
+                    skip();
+                } while (pos < str.size() && str[pos++] == ',');
+                if (str[pos - 1] != ']') error("expect ]");
+            } else if (c == '"') {
+                v.type = Value::String;
+                v.str = string_();
+            } else if (str.compare(pos, 4, "null") == 0) {
+                pos += 4;
+            } else if (str.compare(pos, 4, "true") == 0 || str.compare(pos, 5, "false") == 0) {
+                v.type = Value::Number;
+                v.number = str[pos] == 't';
+                pos += str[pos] == 't' ? 4 : 5;
+            } else {
+                char *end;
+                v.type = Value::Number;
+                v.number = strtod(str.c_str() + pos, &end);
+                if (end == str.c_str() + pos) error("unknown value");
+                pos = static_cast<size_t>(end - str.c_str());
+            }
+            return v;
+        }
+
+        string string_() {
+            if (pos >= str.size() || str[pos] != '"') error("expect string");
+            string res;
+            for (pos++; pos < str.size() && str[pos] != '"'; pos++) {
+                if (str[pos] == '\\' && ++pos < str.size()) {
+                    switch (str[pos]) {
+                        case 'n': res.push_back('\n'); break;
+                        case 't': res.push_back('\t'); break;
+                        case 'u': res.push_back('?'); pos += 4; break;
+                        default: res.push_back(str[pos]);
+                    }
+                } else {
+                    res.push_back(str[pos]);
+                }
+            }
+            if (pos >= str.size()) error("unclosed string");
+            pos++;
+            return res;
+        }
+
+        const string &str;
+        size_t pos = 0;
+    };
+
+    Result toResult(const Value &v) {
+        if (v.type != Value::Object || v["name"].type != Value::String)
+            throw runtime_error("Malformed benchmark JSON: result needs a name");
+        Result r;
+        r.name = v["name"].str;
+        for (const auto &t : v["time_ms"].array) r.times.push_back(t.number);
+        r.allocations = v["allocations"].number;
+        r.points = v["points"].number;
+        r.peakRSS = v["peak_rss_kb"].number;
+        r.result = v["result"].str;
+        return r;
+    }
+
+    string escape(const string &s) {
+        string res;
+        for (auto c : s) {
+            if (c == '"' || c == '\\') res.push_back('\\');
+            res.push_back(c == '\n' ? ' ' : c);
+        }
+        return res;
+    }
+
+    // P(X <= k) for X ~ Binomial(n, 0.5)
+    double binomialCDF(size_t n, size_t k) {
+        double p = pow(0.5, n), sum = 0;
+        for (size_t i = 0; i <= k; i++) {
+            sum += p;
+            p = p * (n - i) / (i + 1);
+        }
+        return sum;
+    }
+
+    string percent(double cur, double base) {
+        ostringstream out;
+        out << showpos << fixed << setprecision(1) << (base > 0 ? (cur / base - 1) * 100 : 0) << "%";
+        return out.str();
+    }
+}
+
+std::string benchmark::toJson(const Result &r) {
+    ostringstream out;
+    out << "{\"name\": \"" << escape(r.name) << "\", \"repetitions\": " << r.times.size() << ", \"time_ms\": [";
+    for (size_t i = 0; i < r.times.size(); i++) out << (i ? ", " : "") << r.times[i];
+    out << "], \"median_ms\": " << (r.times.empty() ? 0 : medianInterval(r.times).median)
+        << ", \"allocations\": " << static_cast<long long>(r.allocations)
+        << ", \"points\": " << static_cast<long long>(r.points)
+        << ", \"peak_rss_kb\": " << static_cast<long long>(r.peakRSS)
+        << ", \"result\": \"" << escape(r.result) << "\"}";
+    return out.str();
+}
+
+Result benchmark::readResult(const std::string &json) {
+    return toResult(Reader{json}.parse());
+}
+
+std::vector<Result> benchmark::readResults(std::istream &in) {
+    string str{istreambuf_iterator<char>(in), istreambuf_iterator<char>()};
+    auto doc = Reader{str}.parse();
+    if (doc["benchmarks"].type != Value::Array)
+        throw runtime_error("Malformed benchmark JSON: no benchmarks array");
+    vector<Result> res;
+    for (const auto &v : doc["benchmarks"].array) res.push_back(toResult(v));
+    return res;
+}
+
+Interval benchmark::medianInterval(std::vector<double> samples) {
+    if (samples.empty()) return {0, 0, 0};
+    sort(samples.begin(), samples.end());
+    auto n = samples.size();
+    auto median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    // [x(j), x(n + 1 - j)] covers the median with probability 1 - 2 * P(X <= j - 1).
+    // With less than 6 samples even [min, max] is below 95%, so that's the best we can do.
+    size_t j = 1;
+    while (j + 1 <= n / 2 && binomialCDF(n, j) <= 0.025) j++;
+    return {samples[j - 1], median, samples[n - j]};
+}
+
+int benchmark::compare(const std::vector<Result> &baseline, const std::vector<Result> &current,
+                       double threshold, std::ostream &os) {
+    int regressions = 0;
+    os << left << setw(16) << "workload" << right << setw(24) << "baseline(ms)" << setw(24) << "current(ms)"
+       << setw(10) << "time" << setw(10) << "allocs" << "  verdict\n";
+    for (const auto &cur : current) {
+        auto base = find_if(baseline.begin(), baseline.end(), [&cur](const Result &r) {
+            return r.name == cur.name;
+        });
+        if (base == baseline.end()) {
+            os << left << setw(16) << cur.name << right << "  not in baseline\n";
+            continue;
+        }
+        auto b = medianInterval(base->times), c = medianInterval(cur.times);
+        bool slower = c.median > b.median * (1 + threshold) && c.low > b.high;
+        bool faster = c.median < b.median * (1 - threshold) && c.high < b.low;
+        bool moreAllocs = cur.allocations > base->allocations * (1 + threshold);
+
+        ostringstream bs, cs;
+        bs << fixed << setprecision(1) << b.median << " [" << b.low << ", " << b.high << "]";
+        cs << fixed << setprecision(1) << c.median << " [" << c.low << ", " << c.high << "]";
+        os << left << setw(16) << cur.name << right << setw(24) << bs.str() << setw(24) << cs.str()
+           << setw(10) << percent(c.median, b.median) << setw(10) << percent(cur.allocations, base->allocations)
+           << "  ";
+        if (slower || moreAllocs) {
+            regressions++;
+            os << "REGRESSION" << (slower ? " (time)" : "") << (moreAllocs ? " (allocations)" : "");
+        } else if (faster) {
+            os << "faster";
+        } else {
+            os << "ok";
+        }
+        if (cur.result != base->result) os << ", result changed: \"" << base->result << "\" -> \"" << cur.result << "\"";
+        os << "\n";
+    }
+    return regressions;
+}
@@ -0,0 +1,42 @@
+#ifndef GI_REGRESSION_H
+#define GI_REGRESSION_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+    // Measurement of one workload, as written in JSON output of benchmark
+    struct Result {
+        std::string name;
+        std::vector<double> times;
+        double allocations = 0;
+        double points = 0;
+        double peakRSS = 0;
+        std::string result;
+    };
+
+    std::string toJson(const Result &);
+
+    // Read a single result object, or all results of a `{"benchmarks": [...]}` document.
+    // Throw std::runtime_error on malformed input.
+    Result readResult(const std::string &json);
+
+    std::vector<Result> readResults(std::istream &);
+
+    // Median with its 95% confidence interval, distribution-free (from order statistics)
+    struct Interval {
+        double low, median, high;
+    };
+
+    Interval medianInterval(std::vector<double> samples);
+
+    // Print comparison of each workload in both runs, and return the number of regressions.
+    // A workload regresses if its allocations grow more than threshold (e.g. 0.1 for 10%), or if its
+    // median time grows more than threshold and the confidence intervals don't overlap.
+    int compare(const std::vector<Result> &baseline, const std::vector<Result> &current,
+                double threshold, std::ostream &);
+}
+
+#endif //GI_REGRESSION_H
@@ -0,0 +1,59 @@
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <arena.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+
+TEST(ArenaTest, AllocationTest) {
+    parser::Arena arena;
+    auto p1 = arena.allocate(3, 1);
+    auto p2 = arena.allocate(sizeof(double), alignof(double));
+    ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(p2) % alignof(double));
+    ASSERT_LT(p1, p2);
+    arena.allocate(1024 * 1024 * 16, 16);
+    ASSERT_EQ(2, arena.blockCount());
+}
+
+TEST(ArenaTest, ParseUnitTest) {
+    std::string src;
+    for (int i = 0; i < 10000; i++)
+        src += "(define (f" + std::to_string(i) + " x) (if (< x 0) x (+ x 1)))\n";
+
+    std::weak_ptr<Arena> weakArena;
+    pExpr all;
+    {
+        ArenaScope unit;
+        weakArena = unit.arena();
+        lexers::Lexer lex{src};
+        all = parseAllExpr(lex);
+        // About 10 nodes per line, but only a few blocks from system
+        ASSERT_LT(unit.arena()->blockCount(), 16);
+        ASSERT_GT(unit.arena()->size(), 10000 * 10 * sizeof(NumberAST));
+    }
+    ASSERT_FALSE(Arena::current());
+
+    // Nodes keep their arena alive after the parse unit ends
+    ASSERT_FALSE(weakArena.expired());
+    auto s = std::make_shared<Scope>();
+    all->eval(s);
+    lexers::Lexer lex{"(f9999 41)"};
+    ASSERT_EQ(42, TO_NUM_PTR(parseAllExpr(lex)->eval(s))->getValue());
+}
+
+TEST(ArenaTest, TeardownTest) {
+    std::weak_ptr<Arena> weakArena;
+    pExpr all;
+    {
+        ArenaScope unit;
+        weakArena = unit.arena();
+        lexers::Lexer lex{"(define (f x) (cond ((< x 0) 0) (else x))) (f 1)"};
+        all = parseAllExpr(lex);
+    }
+    ASSERT_FALSE(weakArena.expired());
+    all.reset();
+    ASSERT_TRUE(weakArena.expired());
+}
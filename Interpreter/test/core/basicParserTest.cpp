@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <parser.h>
+#include <testMacro.h>
 
 using namespace lexers;
 using namespace parser;
@@ -40,3 +41,46 @@ TEST(ParserTest, IdentifierTest) {
     ASSERT_STREQ("abs", idPtr->getId().c_str());
 
 }
+
+template<typename T>
+bool sameKind(const pExpr &expr) {
+    return (nodeAs<T>(expr) != nullptr) == (std::dynamic_pointer_cast<T>(expr) != nullptr);
+}
+
+TEST(ParserTest, NodeKindTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(define (f x) x)");
+    parseAllExpr(lex)->eval(s);
+    const char *exprs[] = {
+        "5", "x", "(f 1)", "(lambda (x) x)", "(define x 1)", "(define (g x) x)", "(load \"a.scm\")",
+        "(if x 1 2)", "(cond (x 1) (else 2))",
+    };
+    const char *values[] = {"#t", "#f", "nil", "(cons 1 2)", "(#vector 1 2)", "(f f)", "(+ 1 2)"};
+    std::vector<pExpr> nodes;
+    for (auto str : exprs) {
+        lex.appendExp(str);
+        nodes.push_back(parseExpr(lex));
+    }
+    for (auto str : values) {
+        lex.appendExp(str);
+        nodes.push_back(parseExpr(lex)->eval(s));
+    }
+    lex.appendExp("1 2");
+    nodes.push_back(parseAllExpr(lex));
+    for (const auto &node : nodes) {
+        ASSERT_TRUE(sameKind<AllExprAST>(node));
+        ASSERT_TRUE(sameKind<BooleansFalseAST>(node));
+        ASSERT_TRUE(sameKind<BooleansTrueAST>(node));
+        ASSERT_TRUE(sameKind<NumberAST>(node));
+        ASSERT_TRUE(sameKind<IdentifierAST>(node));
+        ASSERT_TRUE(sameKind<InvocationAST>(node));
+        ASSERT_TRUE(sameKind<LoadingFileAST>(node));
+        ASSERT_TRUE(sameKind<PairAST>(node));
+        ASSERT_TRUE(sameKind<NilAST>(node));
+        ASSERT_TRUE(sameKind<VectorAST>(node));
+        ASSERT_TRUE(sameKind<ValueBindingAST>(node));
+        ASSERT_TRUE(sameKind<LambdaAST>(node));
+        ASSERT_TRUE(sameKind<LambdaBindingAST>(node));
+    }
+    ASSERT_EQ(NodeKind::OTHER, nodes[7]->kind());
+}
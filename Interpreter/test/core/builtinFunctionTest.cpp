@@ -1,6 +1,7 @@
 #include <memory>
 #include <gtest/gtest.h>
 #include <parser.h>
+#include <exception.h>
 #include <testMacro.h>
 
 using namespace lexers;
@@ -104,3 +105,108 @@ TEST(BuiltinFunctionTest, ListTest) {
     ASSERT_STREQ("2", disp.to_string().c_str());
 }
 
+
+TEST(BuiltinFunctionTest, VectorTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(load \"setup.scm\")");
+    lex.appendExp("(define v (make-vector 3))");
+    REPL_COND("v", true);
+    ASSERT_STREQ("#(0, 0, 0)", disp.to_string().c_str());
+    REPL_COND("(vector-length v)", TO_NUM_PTR(res));
+    ASSERT_EQ(3, numPtr->getValue());
+
+    // Every reference sees vector-set!, also through a function argument
+    lex.appendExp("(define (set-first! vec x) (vector-set! vec 0 x))");
+    lex.appendExp("(set-first! v 7) (vector-set! v 2 (list 1 2))");
+    REPL_COND("v", true);
+    ASSERT_STREQ("#(7, 0, (1, (2, '())))", disp.to_string().c_str());
+    REPL_COND("(vector-ref v 0)", TO_NUM_PTR(res));
+    ASSERT_EQ(7, numPtr->getValue());
+
+    REPL_COND("(vector-map (vector 1 2 3) (lambda (x) (* x x)))", true);
+    ASSERT_STREQ("#(1, 4, 9)", disp.to_string().c_str());
+    REPL_COND("(vector->list (make-vector 2 5))", true);
+    ASSERT_STREQ("(5, (5, '()))", disp.to_string().c_str());
+    REPL_COND("(list->vector (list 1 2))", true);
+    ASSERT_STREQ("#(1, 2)", disp.to_string().c_str());
+    REPL_COND("(vector)", true);
+    ASSERT_STREQ("#()", disp.to_string().c_str());
+
+    lex.appendExp("(vector-ref v 3)");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+    lex.appendExp("(vector-ref v 0.5)");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+    lex.appendExp("(vector-ref (list 1) 0)");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+    // Sizes that aren't a size_t, including NaN, are rejected before being converted
+    for (auto n : {"-1", "1e30", "(/ 0 0)"}) {
+        lex.appendExp(std::string("(make-vector ") + n + ")");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+    }
+
+    // A vector containing itself is displayed with a placeholder for the back-reference;
+    // vector-set! itself displays nothing
+    REPL_COND("(define w (vector 1 2)) (vector-set! w 0 w)", true);
+    ASSERT_STREQ("", disp.to_string().c_str());
+    REPL_COND("(vector-set! w 1 (list w)) w", true);
+    ASSERT_STREQ("#(#(...), (#(...), '()))", disp.to_string().c_str());
+
+    // Names of vector functions are ordinary definitions, so they can be redefined
+    REPL_COND("(define (vector . xs) 42) (vector 1 2)", TO_NUM_PTR(res));
+    ASSERT_EQ(42, numPtr->getValue());
+}
+
+TEST(BuiltinFunctionTest, MemoizeTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(load \"setup.scm\")");
+    // Recursive calls go through the memoized function
+    lex.appendExp("(define-memo (fib n) (if (< n 2) n (+ (fib (+ n -1)) (fib (+ n -2)))))");
+    REPL_COND("(fib 25)", TO_NUM_PTR(res));
+    ASSERT_EQ(75025, numPtr->getValue());
+    REPL_COND("(memo-stats fib)", true);
+    ASSERT_STREQ("(23, 26)", disp.to_string().c_str());
+    REPL_COND("fib", true);
+    ASSERT_STREQ("#proceduce", disp.to_string().c_str());
+
+    // Lists are keys by structure; least recently used result is dropped beyond capacity
+    lex.appendExp("(define sum (memoize (lambda (p) (+ (car p) (cdr p))) 1))");
+    lex.appendExp("(sum (cons 1 2)) (sum (cons 1 2)) (sum (cons 2 1))");
+    REPL_COND("(sum (cons 1 2))", TO_NUM_PTR(res));
+    ASSERT_EQ(3, numPtr->getValue());
+    REPL_COND("(memo-stats sum)", true);
+    ASSERT_STREQ("(1, 3)", disp.to_string().c_str());
+
+    // Vectors may change, so calls with or returning them are made each time
+    lex.appendExp("(define make (memoize (lambda (n) (make-vector n))))");
+    lex.appendExp("(define v (make 2)) (vector-set! v 0 1)");
+    REPL_COND("(make 2)", true);
+    ASSERT_STREQ("#(0, 0)", disp.to_string().c_str());
+    lex.appendExp("(define first (memoize (lambda (v) (vector-ref v 0))))");
+    lex.appendExp("(first v) (vector-set! v 0 5)");
+    REPL_COND("(first v)", TO_NUM_PTR(res));
+    ASSERT_EQ(5, numPtr->getValue());
+    REPL_COND("(memo-stats first)", true);
+    ASSERT_STREQ("(0, 2)", disp.to_string().c_str());
+
+    lex.appendExp("(memo-stats car)");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+    lex.appendExp("(memoize car -1)");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+    lex.appendExp("(memoize car (/ 0 0))");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::RuntimeError);
+
+    // A redefined memoized function recurses into the new definition
+    lex.appendExp("(define-memo (fact n) (if (< n 1) 1 (* n (fact (+ n -1)))))");
+    REPL_COND("(fact 5)", TO_NUM_PTR(res));
+    ASSERT_EQ(120, numPtr->getValue());
+    lex.appendExp("(define-memo (fact n) (if (< n 1) 2 (* n (fact (+ n -1)))))");
+    REPL_COND("(fact 5)", TO_NUM_PTR(res));
+    ASSERT_EQ(240, numPtr->getValue());
+
+    // memoize is an ordinary definition too, which define-memo doesn't depend on
+    REPL_COND("(define (memoize f) 42) (memoize car)", TO_NUM_PTR(res));
+    ASSERT_EQ(42, numPtr->getValue());
+    lex.appendExp("(define-memo (twice n) (* 2 n))");
+    REPL_COND("(twice 4)", TO_NUM_PTR(res));
+    ASSERT_EQ(8, numPtr->getValue());
+}
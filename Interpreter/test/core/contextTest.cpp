@@ -1,6 +1,7 @@
 #include <memory>
 #include <gtest/gtest.h>
 #include <parser.h>
+#include <inlineCache.h>
 #include <testMacro.h>
 
 using namespace lexers;
@@ -52,3 +53,57 @@ TEST(ContextTest, MultipleEvalTest) {
     ASSERT_EQ(0, numPtr->getValue());
     ASSERT_STREQ("0", disp.to_string().c_str());
 }
+
+TEST(ContextTest, FramePoolTest) {
+    CREATE_CONTEXT();
+    // Scopes captured by closures are not reused by later calls
+    lex.appendExp("(define (make-adder n) (lambda (x) (+ x n)))"
+                      "(define add1 (make-adder 1))"
+                      "(define add5 (make-adder 5))"
+                      "(define (count n) (if (< n 1) 0 (+ 1 (count (+ n -1)))))"
+                      "(count 100)");
+    parseAllExpr(lex)->eval(s);
+    REPL_COND("(add1 10)", TO_NUM_PTR(res));
+    ASSERT_EQ(11, numPtr->getValue());
+    REPL_COND("(add5 10)", TO_NUM_PTR(res));
+    ASSERT_EQ(15, numPtr->getValue());
+}
+
+TEST(ContextTest, InlineCacheTest) {
+    CREATE_CONTEXT();
+    // Redefining a callee found through the caller takes effect at once
+    REPL_COND("(define (h x) (k x)) (define (k x) (+ x 1)) (h 1)", TO_NUM_PTR(res));
+    ASSERT_EQ(2, numPtr->getValue());
+    REPL_COND("(define (k x) (* x 10)) (h 1)", TO_NUM_PTR(res));
+    ASSERT_EQ(10, numPtr->getValue());
+    // The same call site resolves f in the scope of each closure
+    lex.appendExp("(define (make f) (lambda (x) (f x)))"
+                      "(define inc (make (lambda (x) (+ x 1))))"
+                      "(define ten (make (lambda (x) (* x 10))))");
+    parseAllExpr(lex)->eval(s);
+    REPL_COND("(+ (inc 1) (ten 1) (inc 2))", TO_NUM_PTR(res));
+    ASSERT_EQ(15, numPtr->getValue());
+
+    // Only definitions in a scope that is a parent of another invalidate the cache
+    auto parent = make_shared<context::Scope>(), child = make_shared<context::Scope>();
+    ASSERT_FALSE(parent->hasChildren);
+    child->setLexicalScope(parent);
+    ASSERT_TRUE(parent->hasChildren);
+    ASSERT_FALSE(child->hasChildren);
+    // A call's scope becomes one once it calls, so later definitions there are seen
+    REPL_COND("(define (mk) (define x 1) (define (get) x) (define a (get)) (define x 5) (+ a (get))) (mk)",
+              TO_NUM_PTR(res));
+    ASSERT_EQ(6, numPtr->getValue());
+
+    // Cache entries don't keep a callee alive once it's rebound
+    std::weak_ptr<ast::ExprAST> callee;
+    {
+        context::InlineCache site;
+        parent->addSymbol("f", make_shared<ast::NumberAST>(1));
+        callee = site.lookup("f", child);
+        ASSERT_FALSE(callee.expired());
+        parent->addSymbol("f", make_shared<ast::NumberAST>(2));
+        ASSERT_TRUE(callee.expired());
+        ASSERT_EQ(2, TO_NUM_PTR(site.lookup("f", child))->getValue());
+    }
+}
@@ -0,0 +1,151 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <escape.h>
+#include <exception.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace exception;
+using visitor::EscapeVisitor;
+using visitor::CaptureVisitor;
+
+#define ESCAPES(str)\
+    lex.appendExp(str);\
+    ast = parseExpr(lex);\
+    ASSERT_TRUE(std::dynamic_pointer_cast<LambdaAST>(ast));\
+    escapes = EscapeVisitor::restEscapes(*std::dynamic_pointer_cast<LambdaAST>(ast));
+
+TEST(EscapeTest, AnalysisTest) {
+    CREATE_CONTEXT();
+    bool escapes;
+    ESCAPES("(lambda (a . r) (if (null? r) a (car (cdr r))))");
+    ASSERT_FALSE(escapes);
+    // Passed to a parameter of inner function which doesn't let it escape
+    ESCAPES("(lambda (a . r)"
+                "  (define (last l) (if (null? (cdr l)) (car l) (last (cdr l))))"
+                "  (define (second x l) (car (cdr l)))"
+                "  (+ (last r) (second a r)))");
+    ASSERT_FALSE(escapes);
+
+    ESCAPES("(lambda (a . r) r)");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (a . r) (cdr r))");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (a . r) (cons a r))");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (a . r) (length (cdr r)))");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (a . r) (lambda (x) r))");
+    ASSERT_TRUE(escapes);
+    // Inner function lets it escape, takes it as rest arguments, or may be rebound
+    ESCAPES("(lambda (a . r) (define (f l) (cdr l)) (f r))");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (a . r) (define (f . l) (car l)) (f r))");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (a . r) (define (f l) (car l)) (define f a) (f r))");
+    ASSERT_TRUE(escapes);
+    ESCAPES("(lambda (f . r) (define (f l) (car l)) (f r))");
+    ASSERT_TRUE(escapes);
+}
+
+TEST(EscapeTest, EvalTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        REPL_COND("(define (sum . r)"
+                      "  (define (iter l acc) (if (null? l) acc (iter (cdr l) (+ acc (car l)))))"
+                      "  (iter r 0))"
+                      "(sum 1 2 3 4)", TO_NUM_PTR(res));
+        ASSERT_EQ(10, numPtr->getValue());
+        REPL_COND("(sum 5)", TO_NUM_PTR(res));
+        ASSERT_EQ(5, numPtr->getValue());
+        REPL_COND("(define (third a . r) (car (cdr r))) (third 1 2 3)", TO_NUM_PTR(res));
+        ASSERT_EQ(3, numPtr->getValue());
+        REPL_COND("(define (end? a . r) (null? (cdr r))) (end? 1 2)", TO_TRUE_PTR(res));
+        REPL_COND("(end? 1 2 3)", TO_FALSE_PTR(res));
+
+        // Escaping rest arguments are a list
+        REPL_COND("(define (rest a . r) r) (rest 1 2 3)", std::dynamic_pointer_cast<PairAST>(res));
+        ASSERT_STREQ("(2, (3, '()))", disp.to_string().c_str());
+        REPL_COND("(define (tail a . r) (cdr r)) (tail 1 2 3)", std::dynamic_pointer_cast<PairAST>(res));
+        ASSERT_STREQ("(3, '())", disp.to_string().c_str());
+
+        // A function called by the lambda finds its rest arguments by dynamic scope as a list,
+        // which outlives the call
+        REPL_COND("(define (h) args) (define (f . args) (h))"
+                      "(define r (f 1 2 3))"
+                      "(define (junk n) (if (< n 1) 0 (junk (+ n -1)))) (junk 1000)"
+                      "(car r)", TO_NUM_PTR(res));
+        ASSERT_EQ(1, numPtr->getValue());
+        REPL_COND("r", true);
+        ASSERT_STREQ("(1, (2, (3, '())))", disp.to_string().c_str());
+        REPL_COND("(define (g) (#length args)) (define (f . args) (g)) (f 1 2)", TO_NUM_PTR(res));
+        ASSERT_EQ(2, numPtr->getValue());
+    END_TRY
+}
+
+#define FLAT(str)\
+    lex.appendExp(str);\
+    ast = parseExpr(lex);\
+    ASSERT_TRUE(std::dynamic_pointer_cast<LambdaAST>(ast));\
+    vars.clear();\
+    flat = CaptureVisitor::freeVariables(*std::dynamic_pointer_cast<LambdaAST>(ast), vars);
+
+TEST(EscapeTest, CaptureTest) {
+    CREATE_CONTEXT();
+    bool flat;
+    std::vector<std::string> vars;
+    FLAT("(lambda (p) p)");
+    ASSERT_TRUE(flat);
+    ASSERT_TRUE(vars.empty());
+    FLAT("(lambda (p) (f (+ dx (car p)) (if (null? p) dy dx)))");
+    ASSERT_TRUE(flat);
+    ASSERT_EQ((std::vector<std::string>{"f", "dx", "dy"}), vars);
+
+    FLAT("(lambda (p) (lambda (q) p))");
+    ASSERT_FALSE(flat);
+    FLAT("(lambda (p) (define x p) x)");
+    ASSERT_FALSE(flat);
+    FLAT("(lambda (p) (let ((x p)) x))");
+    ASSERT_FALSE(flat);
+}
+
+TEST(EscapeTest, FlatClosureTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        REPL_COND("(define (make-adder n) (lambda (x) (+ x n)))"
+                      "(define add3 (make-adder 3))"
+                      "(define add5 (make-adder 5))"
+                      "(+ (add3 1) (add5 1))", TO_NUM_PTR(res));
+        ASSERT_EQ(10, numPtr->getValue());
+        // Free function resolved when closure is created
+        REPL_COND("(define (twice f) (lambda (x) (f (f x))))"
+                      "((twice add3) 0)", TO_NUM_PTR(res));
+        ASSERT_EQ(6, numPtr->getValue());
+        // Not defined yet when closure is created, so it's looked up when called
+        REPL_COND("(define (later) (lambda (x) (g x)))"
+                      "(define h (later))"
+                      "(define (g x) (* x 2))"
+                      "(h 4)", TO_NUM_PTR(res));
+        ASSERT_EQ(8, numPtr->getValue());
+    END_TRY
+}
+
+TEST(EscapeTest, RebindTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        // A recursive function redefined calls the new definition, not the one its name had before
+        REPL_COND("(define (fact n) 0)"
+                      "(define (fact n) (if (< n 1) 1 (* n (fact (+ n -1)))))"
+                      "(fact 5)", TO_NUM_PTR(res));
+        ASSERT_EQ(120, numPtr->getValue());
+        // A local helper recurses into itself rather than the global of the same name
+        REPL_COND("(define (walk l) 0)"
+                      "(define (outer l)"
+                      "  (define (walk l) (if (null? l) 0 (+ 1 (walk (cdr l)))))"
+                      "  (walk l))"
+                      "(outer (list 1 2 3))", TO_NUM_PTR(res));
+        ASSERT_EQ(3, numPtr->getValue());
+    END_TRY
+}
@@ -0,0 +1,61 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <internTable.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using context::InternTable;
+
+TEST(InternTableTest, EqualTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(load \"setup.scm\")");
+    REPL_COND("(equal? (list 1 (cons 2 3)) (list 1 (cons 2 3)))", TO_TRUE_PTR(res));
+    REPL_COND("(equal? (list 1 2) (list 1 2 3))", TO_FALSE_PTR(res));
+    REPL_COND("(equal? (vector 1 (list 2)) (vector 1 (list 2)))", TO_TRUE_PTR(res));
+    REPL_COND("(equal? 0 -0)", TO_TRUE_PTR(res));
+    REPL_COND("(equal? nil nil)", TO_TRUE_PTR(res));
+    REPL_COND("(equal? #t nil)", TO_FALSE_PTR(res));
+    lex.appendExp("(define (f x) x)");
+    REPL_COND("(equal? f f)", TO_TRUE_PTR(res));
+    // Vectors containing themselves are compared without looping
+    lex.appendExp("(define a (vector 1 2)) (vector-set! a 0 a) (define b (vector 1 2)) (vector-set! b 0 b)");
+    REPL_COND("(equal? a b)", TO_TRUE_PTR(res));
+    lex.appendExp("(define c (vector 1 3)) (vector-set! c 0 c)");
+    REPL_COND("(equal? a c)", TO_FALSE_PTR(res));
+    // equal? is an ordinary definition, so it can be redefined
+    REPL_COND("(define (equal? a b) 42) (equal? 1 1)", TO_NUM_PTR(res));
+    ASSERT_EQ(42, numPtr->getValue());
+}
+
+TEST(InternTableTest, HashConsTest) {
+    InternTable::enabled = true;
+    auto base = InternTable::size();
+    {
+        CREATE_CONTEXT();
+        // Equal numbers and pairs made by evaluation are one object
+        lex.appendExp("(define a (cons 1 (cons 2 nil))) (define b (list 1 2))");
+        REPL_COND("a", true);
+        auto a = res;
+        REPL_COND("b", true);
+        ASSERT_EQ(a.get(), res.get());
+        ASSERT_TRUE(a->isCanonical());
+        REPL_COND("(#equal? a b)", TO_TRUE_PTR(res));
+        REPL_COND("(#equal? a (list 1 3))", TO_FALSE_PTR(res));
+        REPL_COND("(car (cdr a))", TO_NUM_PTR(res));
+        ASSERT_EQ(InternTable::number(2).get(), res.get());
+
+        // -0 = 0, and a closure has no structure, so neither is shared
+        REPL_COND("(cons 1 -0)", true);
+        ASSERT_FALSE(res->isCanonical());
+        REPL_COND("(#equal? (cons 1 -0) (cons 1 0))", TO_TRUE_PTR(res));
+        REPL_COND("(cons 1 (lambda (x) x))", true);
+        ASSERT_FALSE(res->isCanonical());
+        ASSERT_GT(InternTable::size(), base);
+    }
+    // Values leave the table with the last reference to them
+    ASSERT_EQ(base, InternTable::size());
+    InternTable::enabled = false;
+    ASSERT_FALSE(InternTable::number(1)->isCanonical());
+}
@@ -0,0 +1,129 @@
+#include <future>
+#include <memory>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <evalLimits.h>
+#include <exception.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace context;
+
+namespace {
+    const char *defs = "(define (id n) n)"
+            "(define (loop n) (if (< n 1) 0 (loop (+ n -1))))"
+            "(define (count n) (if (< n 1) 0 (+ 1 (count (+ n -1)))))"
+            "(define (build n acc) (if (< n 1) acc (build (+ n -1) (cons n acc))))";
+}
+
+TEST(LimitsTest, StepTest) {
+    CREATE_CONTEXT();
+    lex.appendExp(defs);
+    parseAllExpr(lex)->eval(s);
+    Limits limits;
+    limits.steps = 3;
+    {
+        LimitGuard guard{limits};
+        lex.appendExp("(id 1) (id 2) (id 3)");
+        res = parseAllExpr(lex)->eval(s);
+        ASSERT_EQ(3, TO_NUM_PTR(res)->getValue());
+        lex.appendExp("(id 4)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+        // Still exceeded
+        lex.appendExp("(id 5)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+    }
+    // Iterations of tail recursion are steps too
+    limits.steps = 1000;
+    {
+        LimitGuard guard{limits};
+        lex.appendExp("(loop 100000)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+    }
+}
+
+TEST(LimitsTest, DepthTest) {
+    CREATE_CONTEXT();
+    lex.appendExp(defs);
+    parseAllExpr(lex)->eval(s);
+    auto depth = Scope::callTrace.size();
+    Limits limits;
+    limits.depth = 100;
+    {
+        LimitGuard guard{limits};
+        lex.appendExp("(count 50)");
+        res = parseAllExpr(lex)->eval(s);
+        ASSERT_EQ(50, TO_NUM_PTR(res)->getValue());
+        lex.appendExp("(count 1000)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+    }
+    // Call trace is unwound, evaluation goes on
+    ASSERT_EQ(depth, Scope::callTrace.size());
+    lex.appendExp("(count 1000)");
+    res = parseAllExpr(lex)->eval(s);
+    ASSERT_EQ(1000, TO_NUM_PTR(res)->getValue());
+}
+
+TEST(LimitsTest, HeapAndTimeTest) {
+    CREATE_CONTEXT();
+    lex.appendExp(defs);
+    parseAllExpr(lex)->eval(s);
+    Limits limits;
+    limits.heap = 64 * 1024;
+    {
+        LimitGuard guard{limits};
+        lex.appendExp("(build 100 0)");
+        ASSERT_NO_THROW(parseAllExpr(lex)->eval(s));
+        lex.appendExp("(build 1000000 0)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+        // A big vector is refused before it's allocated
+        lex.appendExp("(#make-vector 4e9)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+    }
+    limits = Limits{};
+    limits.time = std::chrono::milliseconds{50};
+    {
+        LimitGuard guard{limits};
+        lex.appendExp("(loop 100000000)");
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{5});
+    }
+}
+
+TEST(LimitsTest, NestedTest) {
+    CREATE_CONTEXT();
+    lex.appendExp(defs);
+    parseAllExpr(lex)->eval(s);
+    Limits outer, inner;
+    outer.steps = 10000;
+    inner.steps = 10;
+    LimitGuard guard{outer};
+    {
+        LimitGuard nested{inner};
+        lex.appendExp("(loop 100)");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+    }
+    // Outer limits are back
+    lex.appendExp("(loop 100)");
+    ASSERT_NO_THROW(parseAllExpr(lex)->eval(s));
+    lex.appendExp("(loop 100000)");
+    ASSERT_THROW(parseAllExpr(lex)->eval(s), exception::LimitExceeded);
+}
+
+TEST(LimitsTest, CancelTest) {
+    Limits limits;
+    auto evaluation = std::async(std::launch::async, [limits]() {
+        CREATE_CONTEXT();
+        lex.appendExp(defs);
+        parseAllExpr(lex)->eval(s);
+        LimitGuard guard{limits};
+        lex.appendExp("(loop 100000000)");
+        parseAllExpr(lex)->eval(s);
+    });
+    ASSERT_EQ(std::future_status::timeout, evaluation.wait_for(std::chrono::milliseconds{20}));
+    limits.cancel.cancel();
+    ASSERT_EQ(std::future_status::ready, evaluation.wait_for(std::chrono::seconds{5}));
+    ASSERT_THROW(evaluation.get(), exception::Cancelled);
+}
@@ -0,0 +1,77 @@
+#include <memory>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <memstats.h>
+#include <framePool.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace profiler;
+
+namespace {
+    // Row of type in report: created, live and peak live
+    std::vector<long> rowOf(const std::string &type) {
+        std::stringstream report;
+        MemoryStats::report(report);
+        std::string line;
+        while (std::getline(report, line)) {
+            if (line.size() > type.size() && line.substr(line.size() - type.size() - 2) == "  " + type) {
+                std::stringstream ss{line};
+                long created, live, peak;
+                ss >> created >> live >> peak;
+                return {created, live, peak};
+            }
+        }
+        return {};
+    }
+}
+
+TEST(MemStatsTest, CounterTest) {
+    MemoryStats::enabled = true;
+    MemoryStats::reset();
+    auto base = MemoryStats::live();
+    {
+        auto num = std::make_shared<NumberAST>(1);
+        auto pair = std::make_shared<PairAST>(num, num);
+        auto copy = pair->getPointer();
+        ASSERT_EQ(base + 3, MemoryStats::live());
+        auto row = rowOf("PairAST");
+        ASSERT_EQ(3u, row.size());
+        ASSERT_EQ(2, row[0]);
+    }
+    ASSERT_EQ(base, MemoryStats::live());
+    ASSERT_EQ(base + 3, MemoryStats::peak());
+    ASSERT_EQ(1, rowOf("NumberAST")[0]);
+
+    // Nothing is counted while disabled
+    MemoryStats::enabled = false;
+    std::make_shared<NumberAST>(1);
+    MemoryStats::enabled = true;
+    ASSERT_EQ(1, rowOf("NumberAST")[0]);
+    MemoryStats::enabled = false;
+}
+
+TEST(MemStatsTest, EvaluationTest) {
+    MemoryStats::enabled = true;
+    MemoryStats::reset();
+    {
+        CREATE_CONTEXT();
+        lex.appendExp("(define (count n) (if (< n 1) 0 (+ 1 (count (+ n -1))))) (count 100)");
+        res = parseAllExpr(lex)->eval(s);
+        ASSERT_EQ(100, TO_NUM_PTR(res)->getValue());
+        // Scopes of earlier calls, created before stats are on, may be reused from the frame pool
+        auto pooled = static_cast<long>(context::FramePool::CAPACITY);
+        ASSERT_GE(rowOf("Scope")[0], 100 - pooled);
+        ASSERT_GE(rowOf("Scope")[2], 100 - pooled);
+        ASSERT_GE(rowOf("LambdaAST")[0], 1);
+
+        lex.appendExp("(#mem-stats)");
+        res = parseAllExpr(lex)->eval(s);
+        // Temporaries of the call are alive while it runs
+        ASSERT_GT(TO_NUM_PTR(res)->getValue(), 0);
+        ASSERT_LE(TO_NUM_PTR(res)->getValue(), MemoryStats::peak());
+    }
+    MemoryStats::enabled = false;
+}
@@ -0,0 +1,103 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <optimizer.h>
+#include <exception.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace exception;
+
+#define OPTIMIZE(str)\
+    lex.appendExp(str);\
+    ast = parseExpr(lex);\
+    res = visitor::optimize(ast);\
+    disp.clear();\
+    res->accept(disp);
+
+TEST(OptimizerTest, FoldingTest) {
+    CREATE_CONTEXT();
+    OPTIMIZE("(+ 1 (* 2 3) (#opposite 0.5))");
+    ASSERT_TRUE(TO_NUM_PTR(res));
+    ASSERT_STREQ("6.5", disp.to_string().c_str());
+
+    OPTIMIZE("(car (cdr (list 1 2 3)))");
+    ASSERT_STREQ("2", disp.to_string().c_str());
+
+    OPTIMIZE("(cons (< 1 2) nil)");
+    ASSERT_STREQ("(#t, '())", disp.to_string().c_str());
+
+    // Unknown function and variable are left as they are
+    OPTIMIZE("(foo (+ 1 x))");
+    ASSERT_TRUE(std::dynamic_pointer_cast<InvocationAST>(res));
+    OPTIMIZE("(bar 1)");
+    ASSERT_EQ(ast, res);
+
+    // Errors are reported at runtime
+    OPTIMIZE("(car 5)");
+    ASSERT_THROW(res->eval(s), NotPair);
+}
+
+TEST(OptimizerTest, BranchTest) {
+    CREATE_CONTEXT();
+    OPTIMIZE("(if (< 2 1) (car 5) (+ 1 1))");
+    ASSERT_STREQ("2", disp.to_string().c_str());
+
+    OPTIMIZE("(cond ((null? nil) #t) (else (car 5)))");
+    ASSERT_TRUE(TO_TRUE_PTR(res));
+
+    OPTIMIZE("(cond ((< x 1) 0) (else 1))");
+    ASSERT_TRUE(std::dynamic_pointer_cast<IfStatementAST>(res));
+    lex.appendExp("(define x 0)");
+    parseAllExpr(lex)->eval(s);
+    ASSERT_EQ(0, TO_NUM_PTR(res->eval(s))->getValue());
+}
+
+TEST(OptimizerTest, TailRecursionTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(define (loop n) (cond ((< n 1) 0) (else (loop (+ n -1)))))");
+    visitor::optimize(parseAllExpr(lex))->eval(s);
+    REPL_COND("(loop 100000)", TO_NUM_PTR(res));
+    ASSERT_EQ(0, numPtr->getValue());
+}
+
+TEST(OptimizerTest, StdlibTest) {
+    CREATE_CONTEXT();
+    visitor::OptimizeVisitor::enabled = false;
+    OPTIMIZE("(+ 1 2)");
+    ASSERT_EQ(ast, res);
+    visitor::OptimizeVisitor::enabled = true;
+
+    lex.appendExp("(load \"setup.scm\")");
+    REPL_COND("(map (list 1 2 3) (lambda (x) (- (* x 2) (+ 1 0))))", true);
+    ASSERT_STREQ("(1, (3, (5, '())))", disp.to_string().c_str());
+}
+
+TEST(OptimizerTest, InlineBuiltinTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(define p (cons 1 2)) (define x 3)");
+    parseAllExpr(lex)->eval(s);
+    OPTIMIZE("(car p)");
+    ASSERT_TRUE(std::dynamic_pointer_cast<InlineBuiltinAST>(res));
+    ASSERT_EQ(1, TO_NUM_PTR(res->eval(s))->getValue());
+    OPTIMIZE("(* (cdr p) (+ x 1))");
+    ASSERT_TRUE(std::dynamic_pointer_cast<InlineBuiltinAST>(res));
+    ASSERT_EQ(8, TO_NUM_PTR(res->eval(s))->getValue());
+    OPTIMIZE("(cons x p)");
+    ASSERT_TRUE(std::dynamic_pointer_cast<InlineBuiltinAST>(res));
+    res = res->eval(s);
+    disp.clear();
+    res->accept(disp);
+    ASSERT_STREQ("(3, (1, 2))", disp.to_string().c_str());
+
+    // Other arities are calls
+    OPTIMIZE("(+ x x x)");
+    ASSERT_FALSE(std::dynamic_pointer_cast<InlineBuiltinAST>(res));
+
+    // Other types are left to the builtin
+    OPTIMIZE("(+ p 1)");
+    ASSERT_THROW(res->eval(s), NotNumber);
+    OPTIMIZE("(cdr x)");
+    ASSERT_THROW(res->eval(s), NotPair);
+}
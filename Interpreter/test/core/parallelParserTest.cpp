@@ -0,0 +1,59 @@
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <exception.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace exception;
+
+namespace {
+    // Large enough to be split into several chunks
+    std::string generateSource(int n) {
+        std::string src = "(define acc 0)\n";
+        for (int i = 0; i < n; i++)
+            src += "(define acc (+ acc " + std::to_string(i) + ")) # add " + std::to_string(i) + "\n";
+        return src + "acc";
+    }
+}
+
+TEST(ParallelParserTest, SourceOrderTest) {
+    CREATE_CONTEXT();
+    auto all = std::dynamic_pointer_cast<AllExprAST>(parseAllExpr(generateSource(5000), 4));
+    auto ret = all->evalAll(s);
+    ASSERT_EQ(5002, ret.size());
+    ASSERT_EQ(5000 * 4999 / 2, TO_NUM_PTR(ret.back())->getValue());
+}
+
+TEST(ParallelParserTest, SmallSourceTest) {
+    CREATE_CONTEXT();
+    ast = parseAllExpr("(define (add x y) (+ x y)) (add 1 2)", 8);
+    res = ast->eval(s);
+    ASSERT_EQ(3, TO_NUM_PTR(res)->getValue());
+}
+
+TEST(ParallelParserTest, ExceptionTest) {
+    ASSERT_THROW(parseAllExpr(generateSource(5000) + "(define)", 4), UnsupportedSyntax);
+    ASSERT_THROW(parseAllExpr(generateSource(5000) + "(define a 0", 4), MissBracket);
+}
+
+TEST(ParallelParserTest, LocationTest) {
+    // Lambdas of every chunk are located as if the whole source was parsed serially
+    auto src = generateSource(5000) + "\n\n(lambda (x) x)\n# comment\n  (lambda (y) y)";
+    auto locations = [](const pExpr &all) {
+        auto s = std::make_shared<Scope>();
+        std::vector<std::string> ret;
+        for (const auto &value: std::dynamic_pointer_cast<AllExprAST>(all)->evalAll(s))
+            if (auto lambda = nodeAs<LambdaAST>(value)) ret.push_back(lambda->getLocation());
+        return ret;
+    };
+    Lexer lex;
+    lex.setName("gen.scm");
+    lex.appendExp(src);
+    auto serial = locations(parseAllExpr(lex));
+    ASSERT_EQ(2, serial.size());
+    ASSERT_EQ("gen.scm:5004", serial[0]);
+    ASSERT_EQ(serial, locations(parseAllExpr(src, 4, "gen.scm")));
+}
@@ -0,0 +1,96 @@
+#include <memory>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <profiler.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace profiler;
+
+#define PROFILE(str)\
+    Profiler::reset();\
+    Profiler::enabled = true;\
+    {\
+        AllocationCounting counting;\
+        lex.appendExp(str);\
+        parseAllExpr(lex)->eval(s);\
+    }\
+    Profiler::enabled = false;
+
+// Calls column of the row for name in flat report, -1 if there is no such row
+long callsOf(const std::string &name) {
+    std::stringstream report;
+    Profiler::report(report);
+    std::string line;
+    while (std::getline(report, line)) {
+        if (line.size() > name.size() && line.substr(line.size() - name.size() - 2) == "  " + name) {
+            std::stringstream ss{line};
+            double percent, self, total;
+            long calls;
+            ss >> percent >> self >> total >> calls;
+            return calls;
+        }
+    }
+    return -1;
+}
+
+TEST(ProfilerTest, ReportTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(define (fib n) (if (< n 2) n (+ (fib (+ n -1)) (fib (+ n -2)))))");
+    parseAllExpr(lex)->eval(s);
+    PROFILE("(define (run) (fib 10)) (run)");
+
+    // fib(10) takes 177 calls
+    ASSERT_EQ(177, callsOf("fib"));
+    ASSERT_EQ(1, callsOf("run"));
+    ASSERT_EQ(177, callsOf("<"));
+    ASSERT_EQ(-1, callsOf("car"));
+}
+
+TEST(ProfilerTest, AnonymousTest) {
+    CREATE_CONTEXT();
+    PROFILE("(define (adder n) (lambda (x) (+ x n)))\n"
+                "((adder 1) ((lambda (y) (+ y 1)) 1))\n"
+                "((adder 2) 0)");
+    // Calls of the same lambda are merged
+    ASSERT_EQ(2, callsOf("(lambda @ <input>:1)"));
+    ASSERT_EQ(1, callsOf("(lambda @ <input>:2)"));
+    ASSERT_EQ(2, callsOf("adder"));
+}
+
+TEST(ProfilerTest, CollapsedStacksTest) {
+    CREATE_CONTEXT();
+    lex.appendExp("(define (loop n) (if (< n 1) 0 (loop (+ n -1))))"
+                      "(define (outer) (loop 2000))");
+    parseAllExpr(lex)->eval(s);
+    PROFILE("(outer)");
+
+    std::stringstream stacks;
+    Profiler::collapsedStacks(stacks);
+    ASSERT_NE(std::string::npos, stacks.str().find("outer;loop "));
+    std::string line;
+    while (std::getline(stacks, line)) {
+        auto pos = line.rfind(' ');
+        ASSERT_NE(std::string::npos, pos);
+        ASSERT_GT(std::stol(line.substr(pos + 1)), 0);
+    }
+
+    Profiler::reset();
+    std::stringstream empty;
+    Profiler::collapsedStacks(empty);
+    ASSERT_TRUE(empty.str().empty());
+}
+
+TEST(ProfilerTest, AllocationTest) {
+    auto before = allocationCount();
+    std::unique_ptr<int> p{new int(1)};
+    // Not counted by default
+    ASSERT_EQ(before, allocationCount());
+    {
+        AllocationCounting counting;
+        p.reset(new int(2));
+        ASSERT_EQ(before + 1, allocationCount());
+    }
+}
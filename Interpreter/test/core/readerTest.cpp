@@ -0,0 +1,73 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <reader.h>
+#include <exception.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace exception;
+
+TEST(ReaderTest, SplitTest) {
+    Reader reader{"(define a 1) a (+ a"};
+    ASSERT_EQ(2, reader.size());
+    ASSERT_EQ(1, reader.depth());
+
+    auto forms = reader.takeForms();
+    ASSERT_STREQ("(define a 1)", forms[0].c_str());
+    ASSERT_STREQ("a", forms[1].c_str());
+    ASSERT_FALSE(reader.ready());
+
+    reader.appendExp("2)");
+    ASSERT_TRUE(reader.ready());
+    ASSERT_EQ(0, reader.depth());
+    ASSERT_STREQ("(+ a\n2)", reader.takeForms().front().c_str());
+
+    // Lines are counted across appended chunks, each of which ends a line
+    reader.appendExp("\n (a)\n# c\nb");
+    std::deque<int> lines;
+    ASSERT_EQ(2, reader.takeForms(&lines).size());
+    ASSERT_EQ((std::deque<int>{3, 5}), lines);
+}
+
+TEST(ReaderTest, CommentTest) {
+    Reader reader;
+    reader.appendExp("# comment (define a").appendExp("#(unused 0)");
+    ASSERT_FALSE(reader.ready());
+    ASSERT_EQ(0, reader.depth());
+
+    reader.appendExp("(#painter #t) #f");
+    auto forms = reader.takeForms();
+    ASSERT_EQ(2, forms.size());
+    ASSERT_STREQ("(#painter #t)", forms[0].c_str());
+    ASSERT_STREQ("#f", forms[1].c_str());
+}
+
+TEST(ReaderTest, BracketTest) {
+    Reader reader{"(car (cons 1 2))"};
+    ASSERT_THROW(reader.appendExp(")"), MissBracket);
+    ASSERT_FALSE(reader.ready());
+    ASSERT_EQ(0, reader.depth());
+}
+
+TEST(ReaderTest, IncrementalEvalTest) {
+    CREATE_CONTEXT();
+    Reader reader;
+    reader.appendExp("(define (add x y)");
+    ASSERT_FALSE(reader.ready());
+    ASSERT_EQ(1, reader.depth());
+
+    reader.appendExp("  (+ x y))");
+    ASSERT_TRUE(reader.ready());
+    reader.parseReady()->eval(s);
+    ASSERT_TRUE(s->count("add"));
+
+    reader.appendExp("(add 1 2) (add 3");
+    res = reader.parseReady()->eval(s);
+    ASSERT_EQ(3, TO_NUM_PTR(res)->getValue());
+
+    reader.appendExp("4)");
+    res = reader.parseReady()->eval(s);
+    ASSERT_EQ(7, TO_NUM_PTR(res)->getValue());
+}
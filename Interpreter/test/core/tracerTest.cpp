@@ -0,0 +1,73 @@
+#include <memory>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <tracer.h>
+#include <testMacro.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace profiler;
+
+TEST(TracerTest, EventTest) {
+    Tracer::clear();
+    Tracer::enabled = true;
+    Tracer::threshold = std::chrono::microseconds{0};
+    {
+        TraceScope trace{"test", "outer \"quoted\""};
+        TraceScope inner{"test", "inner"};
+        inner.setDetail("a\\b\nc");
+        ASSERT_TRUE(inner.sampled());
+    }
+    Tracer::enabled = false;
+    {
+        TraceScope ignored{"test", "ignored"};
+        ASSERT_FALSE(ignored.sampled());
+    }
+    ASSERT_EQ(2u, Tracer::size());
+
+    std::stringstream out;
+    Tracer::write(out);
+    auto json = out.str();
+    ASSERT_EQ(0u, json.find("{\"traceEvents\":["));
+    // Inner one ends first
+    ASSERT_LT(json.find("\"inner\""), json.find("\"outer \\\"quoted\\\"\""));
+    ASSERT_NE(std::string::npos, json.find("\"args\":{\"detail\":\"a\\\\b\\nc\"}"));
+    ASSERT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+    ASSERT_EQ(std::string::npos, json.find("ignored"));
+}
+
+TEST(TracerTest, ThresholdTest) {
+    Tracer::clear();
+    Tracer::enabled = true;
+    Tracer::threshold = std::chrono::microseconds{1000 * 1000};
+    {
+        TraceScope trace{"test", "short"};
+        ASSERT_FALSE(trace.sampled());
+    }
+    Tracer::enabled = false;
+    Tracer::threshold = std::chrono::microseconds{100};
+    ASSERT_EQ(0u, Tracer::size());
+}
+
+TEST(TracerTest, EvaluationTest) {
+    CREATE_CONTEXT();
+    Tracer::clear();
+    Tracer::enabled = true;
+    Tracer::threshold = std::chrono::microseconds{0};
+    lex.appendExp("(define x 1) (load \"stdlib/Base.scm\") (+ x 1)");
+    auto all = std::dynamic_pointer_cast<AllExprAST>(parseAllExpr(lex));
+    all->evalAll(s);
+    Tracer::enabled = false;
+    Tracer::threshold = std::chrono::microseconds{100};
+
+    std::stringstream out;
+    Tracer::write(out);
+    auto json = out.str();
+    ASSERT_NE(std::string::npos, json.find("\"name\":\"load\",\"cat\":\"load\""));
+    ASSERT_NE(std::string::npos, json.find("\"detail\":\"stdlib/Base.scm\""));
+    ASSERT_NE(std::string::npos, json.find("\"detail\":\"define x\""));
+    ASSERT_NE(std::string::npos, json.find("\"detail\":\"(+ ...)\""));
+    ASSERT_NE(std::string::npos, json.find("\"name\":\"parse\""));
+    Tracer::clear();
+}
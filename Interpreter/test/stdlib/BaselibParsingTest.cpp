@@ -152,3 +152,51 @@ TEST(BaseLibrariesParsingTest, lengthTest) {
         ASSERT_EQ(4, numPtr->getValue());
     END_TRY
 }
+
+TEST(BaseLibrariesParsingTest, FilterTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        lex.appendExp("(load \"setup.scm\")");
+        REPL_COND("(filter (list 1 5 2 7 3) (lambda (x) (< 2 x)))", true);
+        ASSERT_STREQ("(5, (7, (3, '())))", disp.to_string().c_str());
+        REPL_COND("(filter nil (lambda (x) #t))", true);
+        ASSERT_STREQ("'()", disp.to_string().c_str());
+    END_TRY
+}
+
+TEST(BaseLibrariesParsingTest, ListEdgeTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        lex.appendExp("(load \"setup.scm\")");
+        REPL_COND("(append nil (list 1) nil (list 2 3))", true);
+        ASSERT_STREQ("(1, (2, (3, '())))", disp.to_string().c_str());
+        REPL_COND("(append (list 1 2))", true);
+        ASSERT_STREQ("(1, (2, '()))", disp.to_string().c_str());
+        REPL_COND("(reverse nil)", true);
+        ASSERT_STREQ("'()", disp.to_string().c_str());
+        REPL_COND("(map nil square)", true);
+        ASSERT_STREQ("'()", disp.to_string().c_str());
+        REPL_COND("(length nil)", TO_NUM_PTR(res));
+        ASSERT_EQ(0, numPtr->getValue());
+        // Builtins and lambdas returned by functions work as op
+        REPL_COND("(reduce (list 1 2 3) + 10)", TO_NUM_PTR(res));
+        ASSERT_EQ(16, numPtr->getValue());
+        REPL_COND("(map (list 1 2) ((lambda (x) square) 0))", true);
+        ASSERT_STREQ("(1, (4, '()))", disp.to_string().c_str());
+
+        lex.appendExp("(length (cons 1 2))");
+        ASSERT_THROW(parseAllExpr(lex)->eval(s), NotPair);
+    END_TRY
+}
+
+TEST(BaseLibrariesParsingTest, ListRedefinitionTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        lex.appendExp("(load \"setup.scm\")");
+        // Names of list functions are ordinary definitions, so they can be shadowed
+        REPL_COND("(define (f) (define (reverse x y) (+ x y)) (reverse 1 2)) (f)", TO_NUM_PTR(res));
+        ASSERT_EQ(3, numPtr->getValue());
+        REPL_COND("(reverse (list 1 2))", true);
+        ASSERT_STREQ("(2, (1, '()))", disp.to_string().c_str());
+    END_TRY
+}
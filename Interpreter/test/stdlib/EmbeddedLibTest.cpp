@@ -0,0 +1,38 @@
+#include <memory>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <parser.h>
+#include <exception.h>
+#include <embeddedLib.h>
+#include <testMacro.h>
+#include <visitor.h>
+
+using namespace lexers;
+using namespace parser;
+using namespace exception;
+
+TEST(EmbeddedLibTest, SourceTest) {
+    ASSERT_EQ(3, embedded::libraries().size());
+    ASSERT_STREQ("Base.scm", embedded::libraries().front().first.c_str());
+    for (const auto &lib: embedded::libraries()) {
+        std::ifstream fin{"stdlib/" + lib.first};
+        std::string str{std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>()};
+        ASSERT_EQ(str, embedded::source(lib.first));
+    }
+    ASSERT_TRUE(embedded::contains("Shape.scm"));
+    ASSERT_FALSE(embedded::contains("setup.scm"));
+    ASSERT_THROW(embedded::source("setup.scm"), RuntimeError);
+}
+
+TEST(EmbeddedLibTest, LoadingTest) {
+    BEG_TRY
+        CREATE_CONTEXT();
+        for (const auto &lib: embedded::libraries())
+            lex.appendExp(lib.second);
+        REPL_COND("(reverse (list 1 2 3))", true);
+        ASSERT_STREQ("(3, (2, (1, '())))", disp.to_string().c_str());
+
+        REPL_COND("(origin-frame default)", true);
+        ASSERT_STREQ("(0, 0)", disp.to_string().c_str());
+    END_TRY
+}
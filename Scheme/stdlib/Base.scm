@@ -50,35 +50,43 @@
 (define (remainder a b)
   (if (< a b) a (remainder (- a b) b)))
 
-(define (reverse l)
-  (define (reverse-iter li res)
-    (if (null? li) res (reverse-iter (cdr li) (cons (car li) res))))
-  (reverse-iter l nil))
-
-(define (append l1 . more)
-  (define (append-iter l1 l2)
-    (if (null? l1) l2 (append-iter (cdr l1) (cons (car l1) l2))))
-  (define (append-list l1 more)
-    (if (null? more) l1
-        (append-list (append-iter (reverse l1) (car more)) (cdr more))))
-  (if (null? more) l1 (append-list l1 more)))
-
-(define (map seq op)
-  (define (map-iter seq res)
-    (if (null? seq) res (map-iter (cdr seq) (cons (op (car seq)) res))))
-  (map-iter (reverse seq) nil))
-
-(define (length seq)
-  (define (length-iter seq n)
-    (if (null? seq) n (length-iter (cdr seq) (+ n 1))))
-  (length-iter seq 0))
+# List functions are native, see builtinAST.h
+(define reverse #reverse)
 
-(define (abs x) ((if (< 0 x) + -) x))
+(define append #append)
+
+(define map #map)
+
+(define length #length)
+
+(define filter #filter)
+
+(define reduce #reduce)
+
+# So are vector functions
+(define make-vector #make-vector)
+
+(define vector #vector)
+
+(define vector-ref #vector-ref)
+
+(define vector-set! #vector-set!)
 
-(define (reduce seq op init)
-  (define (reduce-iter seq res)
-    (if (null? seq) res (reduce-iter (cdr seq) (op res (car seq)))))
-  (reduce-iter seq init))
+(define vector-length #vector-length)
+
+(define vector-map #vector-map)
+
+(define vector->list #vector->list)
+
+(define list->vector #list->vector)
+
+(define equal? #equal?)
+
+(define memoize #memoize)
+
+(define memo-stats #memo-stats)
+
+(define (abs x) ((if (< 0 x) + -) x))
 
 (define (half x) (/ x 2))
 